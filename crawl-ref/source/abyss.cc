@@ -680,7 +680,17 @@ static bool _pushy_feature(dungeon_feature_type feat)
 
 static void _push_items()
 {
-    for (int i = 0; i < MAX_ITEMS; i++)
+    vector<int> floor_items;
+    for (const coord_def &pos : floor_item_cells())
+    {
+        if (!in_bounds(pos))
+            continue;
+
+        for (stack_iterator si(pos); si; ++si)
+            floor_items.push_back(si->index());
+    }
+
+    for (int i : floor_items)
     {
         item_def& item(env.item[i]);
         if (!item.defined() || !in_bounds(item.pos) || item.held_by_monster())
@@ -1340,6 +1350,10 @@ static void _ensure_player_habitable(bool dig_instead)
 static void _abyss_apply_terrain(const map_bitmask &abyss_genlevel_mask,
                                  bool morph = false, bool now = false)
 {
+    // Most of the level gets resampled here, so let the layouts share their
+    // noise work between neighbouring cells.
+    worley::batch noise_batch;
+
     // The chance is reciprocal to these numbers.
     const int depth = you.runes[RUNE_ABYSSAL] ? 5 : you.depth - 2;
     // Cap the chance at the old max depth (5).
@@ -1371,16 +1371,14 @@ int arena_cull_items()
 
     int first_avail = NON_ITEM;
 
-    for (int i = 0; i < MAX_ITEMS; i++)
+    // We want floor items.
+    for (const coord_def &pos : floor_item_cells())
     {
-        // All items in env.item[] are valid when we're called.
-        const item_def &item(env.item[i]);
-
-        // We want floor items.
-        if (!in_bounds(item.pos))
+        if (!in_bounds(pos))
             continue;
 
-        items.push_back(i);
+        for (stack_iterator si(pos); si; ++si)
+            items.push_back(si->index());
     }
 
     // Cull half of items on the floor.
@@ -1708,13 +1708,12 @@ static void _FINGER_AMULET_world_reacts(item_def */*item*/)
 
 static void _reset_victory_stats(item_def *item)
 {
-    int &bonus_stats = item->props[VICTORY_STAT_KEY].get_int();
-    if (bonus_stats > 0)
+    if (item->props[VICTORY_STAT_KEY].get_int() > 0)
     {
-        bonus_stats = 0;
+        item->props[VICTORY_STAT_KEY] = 0;
         item->plus = get_unrand_entry(item->unrand_idx)->plus;
-        artefact_set_property(*item, ARTP_SLAYING, bonus_stats);
-        artefact_set_property(*item, ARTP_INTELLIGENCE, bonus_stats);
+        artefact_set_property(*item, ARTP_SLAYING, 0);
+        artefact_set_property(*item, ARTP_INTELLIGENCE, 0);
         mprf(MSGCH_WARN, "%s stops glowing.", item->name(DESC_THE, false, true,
                                                          false).c_str());
 
@@ -1747,10 +1746,10 @@ static void _VICTORY_death_effects(item_def *item, monster* mons,
     // Using threat for this is kludgy, but easily visible to players.
     if (threat == MTHRT_NASTY || (threat == MTHRT_TOUGH && x_chance_in_y(1, 4)))
     {
-        int &bonus_stats = item->props[VICTORY_STAT_KEY].get_int();
+        int bonus_stats = item->props[VICTORY_STAT_KEY].get_int();
         if (bonus_stats < VICTORY_STAT_CAP)
         {
-            bonus_stats++;
+            item->props[VICTORY_STAT_KEY] = ++bonus_stats;
             item->plus = bonus_stats;
             artefact_set_property(*item, ARTP_SLAYING, bonus_stats);
             artefact_set_property(*item, ARTP_INTELLIGENCE, bonus_stats);
@@ -1203,14 +1203,18 @@ static bool _init_artefact_properties(item_def &item)
     return true;
 }
 
+// These are looked up for every artefact property check, so intern them once.
+static const CrawlHashKey artefact_props_key(ARTEFACT_PROPS_KEY);
+static const CrawlHashKey known_props_key(KNOWN_PROPS_KEY);
+
 void artefact_known_properties(const item_def &item,
                                artefact_known_props_t &known)
 {
     ASSERT(is_artefact(item));
-    if (!item.props.exists(KNOWN_PROPS_KEY)) // randbooks
+    if (!item.props.exists(known_props_key)) // randbooks
         return;
 
-    const CrawlStoreValue &_val = item.props[KNOWN_PROPS_KEY];
+    const CrawlStoreValue &_val = item.props[known_props_key];
     ASSERT(_val.get_type() == SV_VEC);
     const CrawlVector &known_vec = _val.get_vector();
     ASSERT(known_vec.get_type()     == SV_BOOL);
@@ -1234,12 +1238,12 @@ void artefact_properties(const item_def &item,
 {
     ASSERT(is_artefact(item));
     ASSERT(item.base_type != OBJ_BOOKS);
-    ASSERT(item.props.exists(ARTEFACT_PROPS_KEY) || is_unrandom_artefact(item));
+    ASSERT(item.props.exists(artefact_props_key) || is_unrandom_artefact(item));
 
-    if (item.props.exists(ARTEFACT_PROPS_KEY))
+    if (item.props.exists(artefact_props_key))
     {
         const CrawlVector &rap_vec =
-            item.props[ARTEFACT_PROPS_KEY].get_vector();
+            item.props[artefact_props_key].get_vector();
         ASSERT(rap_vec.get_type()     == SV_SHORT);
         ASSERT(rap_vec.size()         == ART_PROPERTIES);
         ASSERT(rap_vec.get_max_size() == ART_PROPERTIES);
@@ -1260,11 +1264,11 @@ int artefact_property(const item_def &item, artefact_prop_type prop)
 {
     ASSERT(is_artefact(item));
     ASSERT(item.base_type != OBJ_BOOKS);
-    ASSERT(item.props.exists(ARTEFACT_PROPS_KEY) || is_unrandom_artefact(item));
-    if (item.props.exists(ARTEFACT_PROPS_KEY))
+    ASSERT(item.props.exists(artefact_props_key) || is_unrandom_artefact(item));
+    if (item.props.exists(artefact_props_key))
     {
         const CrawlVector &rap_vec =
-            item.props[ARTEFACT_PROPS_KEY].get_vector();
+            item.props[artefact_props_key].get_vector();
         return rap_vec[prop].get_short();
     }
     else // if (is_unrandom_artefact(item))
@@ -1284,10 +1288,10 @@ bool artefact_property_known(const item_def &item, artefact_prop_type prop)
     if (item_ident(item, ISFLAG_KNOW_PROPERTIES))
         return true;
 
-    if (!item.props.exists(KNOWN_PROPS_KEY)) // randbooks
+    if (!item.props.exists(known_props_key)) // randbooks
         return false;
 
-    const CrawlVector &known_vec = item.props[KNOWN_PROPS_KEY].get_vector();
+    const CrawlVector &known_vec = item.props[known_props_key].get_vector();
     ASSERT(known_vec.get_type()     == SV_BOOL);
     ASSERT(known_vec.size()         == ART_PROPERTIES);
 
@@ -2243,6 +2247,8 @@ void artefact_set_property(item_def &item, artefact_prop_type prop, int val)
     ASSERT(rap_vec.get_max_size() == ART_PROPERTIES);
 
     rap_vec[prop].get_short() = val;
+    // The item may well be worn.
+    you.equipment_changed();
 }
 
 template<typename Z>
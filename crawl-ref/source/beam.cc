@@ -2136,6 +2136,274 @@ int silver_damages_victim(actor* victim, int damage, string &dmg_msg)
     return ret;
 }
 
+monster_tracer::monster_tracer(bolt &_beam)
+    : beam(_beam), agent(nullptr)
+{
+}
+
+/**
+ * Can the lightweight tracer reproduce what bolt::fire() would do for this
+ * (monster-fired) tracer?
+ *
+ * Everything rejected here either prompts the player, changes shape part way
+ * (explosions, unravelling, combustion breath), depends on the endpoint
+ * (clouds) or rolls its flavour per cell, and needs the full engine.
+ */
+bool monster_tracer::can_trace(const bolt &beam)
+{
+    return !YOU_KILL(beam.thrower)
+           && !beam.is_explosion
+           && !beam.special_explosion
+           && !beam.affects_nothing
+           && !beam.aimed_at_feet
+           && beam.target != beam.source
+           && beam.reflections == 0
+           && beam.bounces == 0
+           && beam.flavour != BEAM_DIGGING
+           && beam.flavour != BEAM_ROOTS
+           && beam.flavour != BEAM_UNRAVELLING
+           && beam.flavour != BEAM_RANDOM
+           && beam.flavour != BEAM_CHAOS
+           && beam.origin_spell != SPELL_CHAIN_LIGHTNING
+           && beam.origin_spell != SPELL_COMBUSTION_BREATH
+           && beam.get_cloud_type() == CLOUD_NONE
+           && !beam.is_big_cloud();
+}
+
+/**
+ * Walk the beam, filling in its foe_info, friend_info, path_taken and
+ * passed_target as bolt::fire() would.
+ *
+ * @return false if the beam bounced; in that case nothing about the beam (or
+ *         the RNG) has been changed and the caller should use bolt::fire().
+ */
+bool monster_tracer::fire()
+{
+    ASSERT(can_trace(beam));
+    ASSERT(beam.is_tracer);
+    ASSERT_IN_BOUNDS(beam.source);
+    ASSERT(beam.range >= 0);
+
+    // These are the only things the walk changes that bolt::fire() would
+    // put back afterwards (see _undo_tracer()); the RNG and passed_target
+    // are only needed if we have to give up.
+    const ray_def old_ray = beam.ray;
+    const coord_def old_target = beam.target;
+    const int old_extra_range = beam.extra_range_used;
+    const beam_type old_real_flavour = beam.real_flavour;
+    const bool old_passed_target = beam.passed_target;
+    const tracer_info old_foe_info = beam.foe_info;
+    const tracer_info old_friend_info = beam.friend_info;
+    const rng::PcgRNG old_rng = rng::current_generator();
+
+    // The parts of initialise_fire() and do_fire() that matter to a
+    // monster tracer.
+    agent = beam.agent();
+    beam.path_taken.clear();
+    beam.extra_range_used = 0;
+    beam.in_explosion_phase = false;
+    beam.use_target_as_pos = false;
+    beam.hit_count.clear();
+    beam.real_flavour = beam.flavour;
+    beam.msg_generated = false;
+
+    beam.choose_ray();
+    beam.ray.advance();
+
+    bool bounced = false;
+    while (map_bounds(beam.pos()))
+    {
+        if (beam.range_used() > beam.range)
+        {
+            beam.ray.regress();
+            beam.extra_range_used++;
+            break;
+        }
+
+        const dungeon_feature_type feat = env.grid(beam.pos());
+        if (feat_is_solid(feat) && !beam.can_affect_wall(beam.pos()))
+        {
+            if (beam.is_bouncy(feat))
+            {
+                bounced = true;
+                break;
+            }
+
+            if (beam.pos() != beam.source && beam.need_regress())
+            {
+                do
+                {
+                    beam.ray.regress();
+                }
+                while (beam.ray.pos() != beam.source
+                       && cell_is_solid(beam.ray.pos()));
+            }
+            break;
+        }
+
+        beam.path_taken.push_back(beam.pos());
+
+        affect_cell();
+
+        if (beam.range_used() > beam.range || beam.beam_cancelled)
+            break;
+
+        if (beam.pos() == beam.target)
+        {
+            beam.passed_target = true;
+            if (beam.stop_at_target())
+                break;
+        }
+
+        beam.noise_generated = false;
+        beam.ray.advance();
+    }
+
+    if (bounced)
+    {
+        // Bounces need the full engine. Nothing has happened to the world
+        // yet, so rewind and let the caller start again.
+        beam.path_taken.clear();
+        beam.hit_count.clear();
+        beam.foe_info = old_foe_info;
+        beam.friend_info = old_friend_info;
+        beam.passed_target = old_passed_target;
+        rng::current_generator() = old_rng;
+    }
+    else if (!map_bounds(beam.pos()))
+    {
+        int tries = max(GXM, GYM);
+        while (!map_bounds(beam.ray.pos()) && tries-- > 0)
+            beam.ray.regress();
+
+        ASSERT(map_bounds(beam.pos()));
+    }
+
+    // affect_endpoint() does nothing for the beams we accept.
+
+    beam.ray = old_ray;
+    beam.target = old_target;
+    beam.extra_range_used = old_extra_range;
+    beam.real_flavour = old_real_flavour;
+
+    if (bounced)
+        return false;
+
+    //XXX: as in bolt::fire(), code relies on path_taken being non-empty
+    if (beam.path_taken.empty())
+        beam.path_taken.push_back(beam.source);
+
+    return true;
+}
+
+// bolt::affect_cell(), minus everything a monster tracer never reaches.
+void monster_tracer::affect_cell()
+{
+    // A tracer stops at any wall it can affect, bar digging.
+    if (cell_is_solid(beam.pos()))
+        beam.finish_beam();
+
+    const bool hit_player = beam.found_player() && !beam.ignores_player();
+    if (hit_player && beam.can_affect_actor(&you))
+    {
+        affect_player();
+        if (beam.hit == AUTOMATIC_HIT && !beam.pierce)
+            beam.finish_beam();
+    }
+
+    if (!hit_player || beam.pierce)
+    {
+        monster *m = monster_at(beam.pos());
+        if (m && beam.can_affect_actor(m))
+        {
+            const bool ignored = beam.ignores_monster(m);
+            affect_monster(m);
+            if (beam.hit == AUTOMATIC_HIT && !beam.pierce && !ignored
+                && agent && m->visible_to(agent))
+            {
+                beam.finish_beam();
+            }
+        }
+    }
+}
+
+// The tracer half of bolt::affect_player().
+void monster_tracer::affect_player()
+{
+    beam.hit_count[MID_PLAYER]++;
+
+    // Friendly penetrating beams stop just short of the player.
+    if (agent && agent->is_monster() && mons_att_wont_attack(beam.attitude)
+        && !beam.harmless_to_player() && beam.pierce)
+    {
+        beam.ray.regress();
+        beam.finish_beam();
+        return;
+    }
+
+    beam.tracer_affect_player();
+}
+
+// The tracer half of bolt::affect_monster().
+void monster_tracer::affect_monster(monster* mon)
+{
+    if (!mon->alive() || mon->type == MONS_GOD_WRATH_AVATAR)
+        return;
+
+    beam.hit_count[mon->mid]++;
+
+    // Jiyva absorbs attacks on slimes.
+    if (agent
+        && beam.flavour != BEAM_VILE_CLUTCH
+        && have_passive(passive_t::neutral_slimes)
+        && god_protects(agent, *mon, true))
+    {
+        beam.finish_beam();
+        return;
+    }
+
+    if (beam.ignores_monster(mon))
+        return;
+
+    beam.tracer_affect_monster(mon);
+}
+
+static bool _same_tracer_info(const tracer_info &a, const tracer_info &b)
+{
+    return a.count == b.count && a.power == b.power && a.hurt == b.hurt
+           && a.helped == b.helped && a.dont_stop == b.dont_stop;
+}
+
+// Fire pbolt through both tracer engines from the same RNG state, and make
+// sure that they come to the same conclusions.
+static void _check_monster_tracer(bolt &pbolt)
+{
+    bolt full = pbolt;
+    const rng::PcgRNG start = rng::current_generator();
+    full.fire();
+    const uint64_t full_rng = rng::peek_uint64();
+
+    rng::current_generator() = start;
+    if (!monster_tracer(pbolt).fire())
+        pbolt.fire();
+
+    ASSERTM(_same_tracer_info(pbolt.foe_info, full.foe_info)
+            && _same_tracer_info(pbolt.friend_info, full.friend_info),
+            "tracer mismatch for '%s' from (%d,%d) to (%d,%d): "
+            "foe %d/%d, friend %d/%d; full engine foe %d/%d, friend %d/%d",
+            pbolt.name.c_str(), pbolt.source.x, pbolt.source.y,
+            pbolt.target.x, pbolt.target.y,
+            pbolt.foe_info.count, pbolt.foe_info.power,
+            pbolt.friend_info.count, pbolt.friend_info.power,
+            full.foe_info.count, full.foe_info.power,
+            full.friend_info.count, full.friend_info.power);
+    ASSERTM(pbolt.path_taken == full.path_taken
+            && pbolt.passed_target == full.passed_target,
+            "tracer path mismatch for '%s'", pbolt.name.c_str());
+    ASSERTM(rng::peek_uint64() == full_rng,
+            "tracer RNG mismatch for '%s'", pbolt.name.c_str());
+}
+
 //  Used by monsters in "planning" which spell to cast. Fires off a "tracer"
 //  which tells the monster what it'll hit if it breathes/casts etc.
 //
@@ -2182,7 +2450,11 @@ void fire_tracer(const monster* mons, bolt &pbolt, bool explode_only,
     // Fire!
     if (explode_only)
         pbolt.explode(false, explosion_hole);
-    else
+    else if (!monster_tracer::can_trace(pbolt))
+        pbolt.fire();
+    else if (crawl_state.check_tracers)
+        _check_monster_tracer(pbolt);
+    else if (!monster_tracer(pbolt).fire())
         pbolt.fire();
 
     // Unset tracer flag (convenience).
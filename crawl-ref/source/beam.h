@@ -314,6 +314,7 @@ private:
     void pull_actor(actor *act, int dam);
 
     // tracers
+    friend class monster_tracer;
     void tracer_affect_player();
     void tracer_affect_monster(monster* mon);
     void tracer_enchantment_affect_monster(monster* mon);
@@ -329,6 +330,29 @@ public:
     ai_action::goodness good_to_fire() const;
 };
 
+// A lightweight tracer for monster-fired beams. It walks the beam's ray in
+// place and collects friend/foe information exactly as bolt::fire() would for
+// a tracer, but without copying the bolt or passing through the drawing,
+// noise, message and side-effect code that a real beam needs. Only beams that
+// can_trace() accepts are handled; fire() returns false (leaving the beam as
+// it found it) if the walk runs into something it can't model.
+class monster_tracer
+{
+public:
+    monster_tracer(bolt &beam);
+
+    static bool can_trace(const bolt &beam);
+    bool fire();
+
+private:
+    void affect_cell();
+    void affect_player();
+    void affect_monster(monster* mon);
+
+    bolt &beam;
+    const actor *agent;
+};
+
 int mons_adjust_flavoured(monster* mons, bolt &pbolt, int hurted,
                           bool doFlavouredEffects = true);
 
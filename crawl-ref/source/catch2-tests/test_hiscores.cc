@@ -0,0 +1,45 @@
+#include "catch_amalgamated.hpp"
+
+#include "AppHdr.h"
+
+#include "hiscores.h"
+#include "initfile.h"
+#include "stringutil.h"
+#include "syscalls.h"
+#include "unwind.h"
+
+static scorefile_entry _quit_entry(const string &name, int score)
+{
+    scorefile_entry se;
+    REQUIRE(se.parse(make_stringf(
+        "v=0.32:name=%s:race=Human:cls=Fighter:char=HuFi:xl=1:sk=Fighting"
+        ":sklev=1:title=Skirmisher:place=D::1:br=D:lvl=1:absdepth=1:hp=10"
+        ":mhp=10:mmhp=10:dur=10:turn=10:sc=%d:ktyp=quitting"
+        ":tmsg=quit the game\n", name.c_str(), score)));
+    return se;
+}
+
+TEST_CASE( "Tied scores rank the same after the index is rebuilt",
+           "[single-file]" ) {
+    unwind_var<string> scorefile(SysEnv.scorefile, "catch2-test-scores");
+    const string index = SysEnv.scorefile + ".idx";
+    unlink_u(SysEnv.scorefile.c_str());
+    unlink_u(index.c_str());
+
+    // Earlier in the file ranks higher.
+    REQUIRE(hiscores_new_entry(_quit_entry("Alice", 100)) == 0);
+    REQUIRE(hiscores_new_entry(_quit_entry("Bob", 100)) == 1);
+
+    int start;
+    const string before = hiscores_print_list(10, SCORE_TERSE, -1, start);
+    REQUIRE(before.find("Alice") < before.find("Bob"));
+
+    REQUIRE(unlink_u(index.c_str()) == 0);
+    const string after = hiscores_print_list(10, SCORE_TERSE, -1, start);
+    REQUIRE(after == before);
+
+    REQUIRE(hiscores_new_entry(_quit_entry("Carol", 100)) == 2);
+
+    unlink_u(SysEnv.scorefile.c_str());
+    unlink_u(index.c_str());
+}
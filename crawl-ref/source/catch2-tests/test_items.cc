@@ -10,6 +10,8 @@
 #include "invent.h"
 #include "player-equip.h"
 #include "potion-type.h"
+#include "state.h"
+#include "unwind.h"
 
 #include "test_player_fixture.h"
 
@@ -184,6 +186,32 @@ TEST_CASE_METHOD( MockPlayerYouTestsFixture,
     REQUIRE(you.base_ac(100) == 1200);
 }
 
+TEST_CASE_METHOD( MockPlayerYouTestsFixture,
+                  "Equipment totals follow equipping, melding and egos",
+                  "[single-file]" ) {
+    // Any stale totals will also fail an assertion in equip_totals().
+    unwind_bool check(crawl_state.check_equip_cache, true);
+
+    make_and_equip_item(OBJ_ARMOUR, ARM_CLOAK, 0, SPARM_POISON_RESISTANCE);
+    REQUIRE(you.equip_totals().res_pois == 1);
+    REQUIRE(you.wearing_ego(EQ_ALL_ARMOUR, SPARM_POISON_RESISTANCE) == 1);
+
+    REQUIRE(meld_slot(EQ_CLOAK));
+    REQUIRE(you.equip_totals().res_pois == 0);
+    REQUIRE(unmeld_slot(EQ_CLOAK));
+    REQUIRE(you.equip_totals().res_pois == 1);
+
+    item_def &cloak = you.inv[you.equip[EQ_CLOAK]];
+    REQUIRE(set_item_ego_type(cloak, OBJ_ARMOUR, SPARM_RESISTANCE));
+    REQUIRE(you.equip_totals().res_pois == 0);
+    REQUIRE(you.equip_totals().res_fire == 1);
+    REQUIRE(you.equip_totals().res_cold == 1);
+
+    REQUIRE(unequip_item(EQ_CLOAK, false));
+    REQUIRE(you.equip_totals().res_fire == 0);
+    REQUIRE(you.wearing_ego(EQ_ALL_ARMOUR, SPARM_RESISTANCE) == 0);
+}
+
 TEST_CASE("armour_prop_test", "[single-file]"){
     REQUIRE(armour_prop(ARM_SCALE_MAIL, PARM_AC) == 6);
 }
@@ -0,0 +1,145 @@
+#include "catch_amalgamated.hpp"
+
+#include "AppHdr.h"
+
+#include "pattern.h"
+
+TEST_CASE( "text_pattern matches regexes", "[single-file]" )
+{
+    text_pattern scroll("scrolls? of (teleportation|blinking)");
+    CHECK(scroll.matches("a scroll of teleportation"));
+    CHECK(scroll.matches("3 scrolls of blinking"));
+    CHECK_FALSE(scroll.matches("a scroll of fog"));
+    CHECK_FALSE(scroll.matches("a Scroll of Teleportation"));
+
+    text_pattern icase("scroll of teleportation", true);
+    CHECK(icase.matches("a Scroll of Teleportation"));
+
+    SECTION( "only the given length is searched" )
+    {
+        const char *text = "a wand of digging (12)";
+        CHECK(text_pattern("digging$").matches(text, 17));
+        CHECK_FALSE(text_pattern("\\(12\\)").matches(text, 17));
+    }
+
+    SECTION( "bad and empty patterns are invalid and match nothing" )
+    {
+        text_pattern bad("scrolls? of (teleportation");
+        CHECK_FALSE(bad.valid());
+        CHECK_FALSE(bad.matches("scroll of teleportation"));
+
+        text_pattern empty("");
+        CHECK_FALSE(empty.valid());
+        CHECK_FALSE(empty.matches(""));
+        CHECK_FALSE(text_pattern().valid());
+    }
+}
+
+TEST_CASE( "text_pattern copies and assignments", "[single-file]" )
+{
+    text_pattern potion("potions? of curing", true);
+    REQUIRE(potion.valid());
+
+    // Copies share the compiled regex, but must still behave as their own.
+    text_pattern copy(potion);
+    CHECK(copy.matches("a Potion of Curing"));
+    CHECK(copy == potion);
+
+    copy = "potions? of heal wounds";
+    CHECK(copy.matches("2 potions of heal wounds"));
+    CHECK_FALSE(copy.matches("a potion of curing"));
+    CHECK(potion.matches("a potion of curing"));
+
+    // The same pattern with different case sensitivity is a different regex.
+    text_pattern cased("potions? of curing");
+    CHECK_FALSE(cased.matches("a Potion of Curing"));
+    CHECK(potion.matches("a Potion of Curing"));
+
+    text_pattern bad("(");
+    CHECK_FALSE(bad.valid());
+    text_pattern bad_copy(bad);
+    CHECK_FALSE(bad_copy.valid());
+
+    SECTION( "match locations" )
+    {
+        pattern_match m = potion.match_location("3 potions of curing");
+        REQUIRE(m);
+        CHECK(m.annotate_string("w") == "3 <w>potions of curing</w>");
+        CHECK_FALSE(cased.match_location("3 Potions of Curing"));
+    }
+}
+
+// Run with: ./catch2-tests-executable "[benchmark]"
+TEST_CASE( "text_pattern benchmarks", "[.][benchmark]" )
+{
+    const vector<string> items = {
+        "a +0 dagger", "3 potions of curing", "a scroll of teleportation",
+        "a wand of digging (12)", "the +2 ring of Fire {rF++ rC-}",
+        "12 stones", "a book of Fire", "an amulet of faith",
+        "a +1 robe of resistance", "5 scrolls of blinking",
+    };
+    const vector<string> messages = {
+        "You hear a distant slurping noise.",
+        "The orc warrior hits you but does no damage.",
+        "You feel a bit more experienced.",
+        "The goblin misses you.",
+        "You see here a scroll of teleportation.",
+        "Your spell is not yet ready.",
+    };
+    const vector<string> stashes = {
+        "(D:3) a +0 dagger; 3 potions of curing; a scroll of teleportation",
+        "(Lair:2) shop: 12 stones; a book of Fire; an amulet of faith",
+        "(Orc:1) a wand of digging (12); a +1 robe of resistance",
+    };
+
+    // As in the options: every pattern is made once and kept.
+    const vector<text_pattern> autopickup = {
+        text_pattern("potions? of (curing|heal wounds)", true),
+        text_pattern("scrolls? of (teleportation|blinking)", true),
+        text_pattern("^(an?|the) .*ring of", true),
+        text_pattern("wand of", true),
+    };
+    const vector<text_pattern> filters = {
+        text_pattern("You hear"),
+        text_pattern("(misses|hits) you"),
+        text_pattern("^Your spell"),
+    };
+
+    BENCHMARK( "autopickup" )
+    {
+        int hits = 0;
+        for (const string &item : items)
+            for (const text_pattern &pat : autopickup)
+                hits += pat.matches(item);
+        return hits;
+    };
+
+    BENCHMARK( "message filter" )
+    {
+        int hits = 0;
+        for (const string &msg : messages)
+            for (const text_pattern &pat : filters)
+                hits += pat.matches(msg);
+        return hits;
+    };
+
+    // As in stash search: a new pattern from the search box each time.
+    BENCHMARK( "stash search" )
+    {
+        text_pattern search("scroll|wand", true);
+        int hits = 0;
+        for (const string &stash : stashes)
+            hits += search.matches(stash);
+        return hits;
+    };
+
+    // Copying patterns, as the option vectors and menus do.
+    BENCHMARK( "copy and match" )
+    {
+        vector<text_pattern> copies(autopickup);
+        int hits = 0;
+        for (const text_pattern &pat : copies)
+            hits += pat.matches(items[1]);
+        return hits;
+    };
+}
@@ -43,12 +43,78 @@
 #include "terrain.h"
 #include "rltiles/tiledef-main.h"
 #include "traps.h"
+#include "turn-profile.h"
 #include "unwind.h"
 #include "xom.h"
 
+cloud_grid::cloud_grid()
+    : present(false)
+{
+}
+
+cloud_struct *cloud_grid::find(const coord_def &p)
+{
+    if (!map_bounds(p) || !present(p))
+        return nullptr;
+    return &cells(p);
+}
+
+const cloud_struct *cloud_grid::find(const coord_def &p) const
+{
+    if (!map_bounds(p) || !present(p))
+        return nullptr;
+    return &cells(p);
+}
+
+/// Put a copy of cloud at p, replacing any cloud already there.
+cloud_struct &cloud_grid::insert(const coord_def &p, const cloud_struct &cloud)
+{
+    ASSERT_IN_BOUNDS(p);
+    if (!present(p))
+    {
+        present(p) = true;
+        occupied.insert(lower_bound(occupied.begin(), occupied.end(), p), p);
+    }
+    cells(p) = cloud;
+    cells(p).pos = p;
+    return cells(p);
+}
+
+void cloud_grid::erase(const coord_def &p)
+{
+    if (!map_bounds(p) || !present(p))
+        return;
+
+    occupied.erase(lower_bound(occupied.begin(), occupied.end(), p));
+    present(p) = false;
+    cells(p) = cloud_struct();
+}
+
+void cloud_grid::clear()
+{
+    for (const coord_def &p : occupied)
+    {
+        present(p) = false;
+        cells(p) = cloud_struct();
+    }
+    occupied.clear();
+}
+
+/**
+ * The positions of all clouds, in the (x-major) order that a
+ * map<coord_def, cloud_struct> would have them in. Anything that rolls
+ * random numbers per cloud should go through this, so that seeded games
+ * don't depend on the order in which clouds happened to be created.
+ * This is a copy, so clouds may be placed or removed while walking it.
+ */
+vector<coord_def> cloud_grid::positions() const
+{
+    return occupied;
+}
+
 cloud_struct* cloud_at(coord_def pos)
 {
-    return map_find(env.cloud, pos);
+    return env.cloud.find(pos);
 }
 
 /// damage = base + random2avg(random, random/15 + 1)
@@ -435,10 +501,9 @@ static int _spread_cloud(const cloud_struct &cloud)
         if (newdecay >= cloud.decay)
             newdecay = cloud.decay - 1;
 
-        env.cloud[*ai] = cloud;
-        env.cloud[*ai].pos = *ai;
-        env.cloud[*ai].decay = newdecay;
-        _los_cloud_changed(env.cloud[*ai].pos, env.cloud[*ai].type, CLOUD_NONE);
+        cloud_struct &spread = env.cloud.insert(*ai, cloud);
+        spread.decay = newdecay;
+        _los_cloud_changed(spread.pos, spread.type, CLOUD_NONE);
 
         extra_decay += 8;
     }
@@ -462,10 +527,9 @@ static void _spread_fire(const cloud_struct &cloud)
         // burning trees produce flames all around
         if (!cell_is_solid(*ai) && make_flames)
         {
-            env.cloud[*ai] = cloud;
-            env.cloud[*ai].type = CLOUD_FIRE;
-            env.cloud[*ai].pos = *ai;
-            env.cloud[*ai].decay = cloud.decay / 2 + 1;
+            cloud_struct &flames = env.cloud.insert(*ai, cloud);
+            flames.type = CLOUD_FIRE;
+            flames.decay = cloud.decay / 2 + 1;
         }
 
         // forest fire doesn't spread in all directions at once,
@@ -482,9 +546,8 @@ static void _spread_fire(const cloud_struct &cloud)
         if (you.see_cell(*ai))
             mpr("The forest fire spreads!");
         destroy_wall(*ai);
-        env.cloud[*ai] = cloud;
-        env.cloud[*ai].pos = *ai;
-        env.cloud[*ai].decay = random2(30) + 25;
+        cloud_struct &fire = env.cloud.insert(*ai, cloud);
+        fire.decay = random2(30) + 25;
 
     }
 }
@@ -504,10 +567,12 @@ static void _cloud_interacts_with_terrain(const cloud_struct &cloud)
             && one_chance_in(14))
         {
             const cloud_type old = cloud_type_at(p);
-            env.cloud[p] = cloud_struct(p, CLOUD_STEAM, 2 + random2(5),
-                                        11, cloud.whose, cloud.killer,
-                                        cloud.source, -1);
-            _los_cloud_changed(p, env.cloud[p].type, old);
+            const cloud_struct &steam =
+                env.cloud.insert(p, cloud_struct(p, CLOUD_STEAM,
+                                                 2 + random2(5), 11,
+                                                 cloud.whose, cloud.killer,
+                                                 cloud.source, -1));
+            _los_cloud_changed(p, steam.type, old);
         }
     }
 }
@@ -596,14 +661,16 @@ static void _handle_spectral_cloud(const cloud_struct& cloud)
 
 void manage_clouds()
 {
-    // We can't iterate over env.cloud directly because _dissipate_cloud
-    // will remove this cloud and invalidate our iterator.
-    vector<cloud_struct *> cloud_ptrs;
-    for (auto& entry : env.cloud)
-        cloud_ptrs.push_back(&entry.second);
+    TURN_PROFILE_SCOPE(clouds);
+    TURN_PROFILE_COUNT(clouds, env.cloud.size());
 
-    for (auto ptr : cloud_ptrs)
+    // Only clouds that exist at the start of the turn act; anything they
+    // spread into waits until next turn.
+    for (const coord_def &pos : env.cloud.positions())
     {
+        cloud_struct *ptr = cloud_at(pos);
+        if (!ptr)
+            continue;
         cloud_struct& cloud = *ptr;
 
 #ifdef ASSERTS
@@ -653,13 +720,7 @@ void delete_cloud(coord_def p)
 
 void delete_all_clouds()
 {
-    // We can't iterate over env.cloud directly because delete_cloud
-    // will remove this cloud and invalidate our iterator.
-    vector<coord_def> cloud_locs;
-    for (auto& entry : env.cloud)
-        cloud_locs.push_back(entry.first);
-
-    for (auto pos : cloud_locs)
+    for (const coord_def &pos : env.cloud.positions())
         delete_cloud(pos);
 }
 
@@ -673,11 +734,11 @@ void move_cloud(coord_def src, coord_def newpos)
 
     const cloud_type old = cloud_type_at(newpos);
 
-    env.cloud[newpos] = env.cloud[src];
+    const cloud_struct moved = *cloud_at(src);
     env.cloud.erase(src);
-    env.cloud[newpos].pos = newpos;
-    _los_cloud_changed(src, CLOUD_NONE, env.cloud[newpos].type);
-    _los_cloud_changed(newpos, env.cloud[newpos].type, old);
+    const cloud_struct &cloud = env.cloud.insert(newpos, moved);
+    _los_cloud_changed(src, CLOUD_NONE, cloud.type);
+    _los_cloud_changed(newpos, cloud.type, old);
 }
 
 void swap_clouds(coord_def p1, coord_def p2)
@@ -695,13 +756,11 @@ void swap_clouds(coord_def p1, coord_def p2)
         return;
     }
 
-    cloud_struct temp = env.cloud[p1];
-    env.cloud[p1] = env.cloud[p2];
-    env.cloud[p2] = temp;
-    env.cloud[p1].pos = p1;
-    env.cloud[p2].pos = p2;
-    _los_cloud_changed(p1, env.cloud[p1].type, env.cloud[p2].type);
-    _los_cloud_changed(p2, env.cloud[p2].type, env.cloud[p1].type);
+    const cloud_struct temp = *cloud_at(p1);
+    const cloud_struct &c1 = env.cloud.insert(p1, *cloud_at(p2));
+    const cloud_struct &c2 = env.cloud.insert(p2, temp);
+    _los_cloud_changed(p1, c1.type, c2.type);
+    _los_cloud_changed(p2, c2.type, c1.type);
 }
 
 // Places a cloud with the given stats assuming one doesn't already
@@ -804,10 +863,11 @@ void place_cloud(cloud_type cl_type, const coord_def& ctarget, int cl_range,
     // possible to overwrite an opaque cloud with a non-opaque one; OOD will do
     // this.
     const cloud_type old = cloud ? cloud->type : CLOUD_NONE;
-    env.cloud[ctarget] = cloud_struct(ctarget, cl_type, cl_range * 10,
-            _actual_spread_rate(cl_type, spread_rate), whose, killer, source,
-            excl_rad);
-    _los_cloud_changed(ctarget, env.cloud[ctarget].type, old);
+    const cloud_struct &placed = env.cloud.insert(ctarget,
+            cloud_struct(ctarget, cl_type, cl_range * 10,
+                         _actual_spread_rate(cl_type, spread_rate), whose,
+                         killer, source, excl_rad));
+    _los_cloud_changed(ctarget, placed.type, old);
 }
 
 bool is_opaque_cloud(cloud_type ctype)
@@ -1743,15 +1803,12 @@ void remove_vortex_clouds(mid_t whose)
     // spell (excluding immobile and mindless casters).
     // XXX: this comment seems impossibly out of date? ^
 
-    // We can't iterate over env.cloud directly because delete_cloud
-    // will remove this cloud and invalidate our iterator.
-    vector<coord_def> vortices;
-    for (auto& entry : env.cloud)
-        if (entry.second.type == CLOUD_VORTEX && entry.second.source == whose)
-            vortices.push_back(entry.first);
-
-    for (auto pos : vortices)
-        delete_cloud(pos);
+    for (const coord_def &pos : env.cloud.positions())
+    {
+        const cloud_struct &cloud = *cloud_at(pos);
+        if (cloud.type == CLOUD_VORTEX && cloud.source == whose)
+            delete_cloud(pos);
+    }
 }
 
 static void _spread_cloud(coord_def pos, cloud_type type, int radius, int pow,
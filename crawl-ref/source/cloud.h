@@ -5,6 +5,12 @@
 
 #pragma once
 
+#include <vector>
+
+#include "fixedarray.h"
+
+using std::vector;
+
 struct cloud_struct
 {
     coord_def     pos;
@@ -39,6 +45,38 @@ struct cloud_struct
     static killer_type   whose_to_killer(kill_category whose);
 };
 
+/**
+ * The clouds on the current level.
+ *
+ * Each cell has its own cloud_struct slot, so looking up the cloud at a
+ * position is a single array access, and a cloud stays where it is until it
+ * is erased: pointers from cloud_at() remain good while other clouds are
+ * placed or removed. A sorted list of the occupied cells means that walking
+ * every cloud doesn't have to scan the whole level.
+ */
+class cloud_grid
+{
+public:
+    cloud_grid();
+
+    cloud_struct *find(const coord_def &p);
+    const cloud_struct *find(const coord_def &p) const;
+    cloud_struct &insert(const coord_def &p, const cloud_struct &cloud);
+    void erase(const coord_def &p);
+    void clear();
+
+    int size() const { return occupied.size(); }
+    bool empty() const { return occupied.empty(); }
+
+    vector<coord_def> positions() const;
+
+private:
+    FixedArray<cloud_struct, GXM, GYM> cells;
+    FixedArray<bool, GXM, GYM> present;
+    // Kept in coord_def order; see positions().
+    vector<coord_def> occupied;
+};
+
 enum cloud_tile_variation
 {
     CTVARY_NONE,     ///< fixed tile (or special case)
@@ -24,6 +24,19 @@
 #include "stringutil.h"
 #include "syscalls.h"
 #include "unicode.h"
+#include "unwind.h"
+#include "version.h"
+
+// An index from the words of each entry to the entries containing them, so
+// that literal searches only have to look at a few candidate entries instead
+// of pattern-matching the whole database. Words are lowercased runs of ASCII
+// letters and digits.
+struct db_word_index
+{
+    vector<string> keys;                 // in DBM iteration order
+    map<string, vector<int>> key_words;  // word -> indices into keys
+    map<string, vector<int>> body_words;
+};
 
 // TextDB handles dependency checking the db vs text files, creating the
 // db, loading, and destroying the DB.
@@ -36,8 +49,10 @@ public:
     TextDB(TextDB *parent);
     ~TextDB() { shutdown(true); delete translation; }
     void init();
+    void prebuild(const string &dir);
     void shutdown(bool recursive = false);
     DBM* get() { return _db; }
+    const db_word_index &word_index();
 
     // Make it easier to migrate from raw DBM* to TextDB
     operator bool() const { return _db != 0; }
@@ -46,6 +61,9 @@ public:
  private:
     bool _needs_update() const;
     void _regenerate_db();
+    bool _open_prebuilt();
+    string _build_db(const string &db_path);
+    bool _has_input_files() const;
 
  private:
     bool open_db();
@@ -55,6 +73,7 @@ public:
     DBM* _db;
     string timestamp;
     TextDB *_parent;
+    db_word_index *_index;
     const char* lang() { return _parent ? Options.lang_name : 0; }
 public:
     TextDB *translation;
@@ -162,13 +181,26 @@ static string _db_cache_path(string db, const char *lang)
     return savedir_versioned_path("db/" + db);
 }
 
+// Prebuilt databases are named like cached ones, but live in the data
+// directory and have no timestamp: instead they record the game version.
+static string _db_prebuilt_name(string db, const char *lang)
+{
+    if (lang)
+        db = db + "." + lang;
+    return db + ".db";
+}
+
+#define DB_VERSION_KEY "__VERSION__"
+
+
 // ----------------------------------------------------------------------
 // TextDB
 // ----------------------------------------------------------------------
 
 TextDB::TextDB(const char* db_name, const char* dir, vector<string> files)
     : _db_name(db_name), _directory(dir), _input_files(files),
-      _db(nullptr), timestamp(""), _parent(0), translation(0)
+      _db(nullptr), timestamp(""), _parent(0), _index(nullptr),
+      translation(0)
 {
 }
 
@@ -176,7 +208,8 @@ TextDB::TextDB(TextDB *parent)
     : _db_name(parent->_db_name),
       _directory(parent->_directory + Options.lang_name + "/"),
       _input_files(parent->_input_files), // FIXME: pointless copy
-      _db(nullptr), timestamp(""), _parent(parent), translation(nullptr)
+      _db(nullptr), timestamp(""), _parent(parent), _index(nullptr),
+      translation(nullptr)
 {
 }
 
@@ -205,6 +238,9 @@ void TextDB::init()
         translation->init();
     }
 
+    if (_open_prebuilt())
+        return;
+
     open_db();
 
     if (!_needs_update())
@@ -225,10 +261,66 @@ void TextDB::shutdown(bool recursive)
         dbm_close(_db);
         _db = nullptr;
     }
+    delete _index;
+    _index = nullptr;
     if (recursive && translation)
         translation->shutdown(recursive);
 }
 
+// Split text into its index words, in order of appearance.
+static vector<string> _db_words(const char *text, int length)
+{
+    vector<string> words;
+    string word;
+    for (int i = 0; i <= length; ++i)
+    {
+        const char c = i < length ? text[i] : 0;
+        if (isaalnum(c))
+            word += tolower_safe(c);
+        else if (!word.empty())
+        {
+            words.push_back(word);
+            word.clear();
+        }
+    }
+    return words;
+}
+
+static void _index_words(map<string, vector<int>> &index, int entry,
+                         const char *text, int length)
+{
+    for (const string &word : _db_words(text, length))
+    {
+        vector<int> &entries = index[word];
+        if (entries.empty() || entries.back() != entry)
+            entries.push_back(entry);
+    }
+}
+
+// The index is built the first time the database is searched rather than
+// when it is regenerated, since most runs reuse an existing database file.
+const db_word_index &TextDB::word_index()
+{
+    ASSERT(_db);
+    if (_index)
+        return *_index;
+
+    _index = new db_word_index;
+    for (datum dbKey = dbm_firstkey(_db); dbKey.dptr != nullptr;
+         dbKey = dbm_nextkey(_db))
+    {
+        const int entry = _index->keys.size();
+        _index->keys.emplace_back((const char *)dbKey.dptr, dbKey.dsize);
+        _index_words(_index->key_words, entry,
+                     (const char *)dbKey.dptr, dbKey.dsize);
+
+        datum dbBody = dbm_fetch(_db, dbKey);
+        _index_words(_index->body_words, entry,
+                     (const char *)dbBody.dptr, dbBody.dsize);
+    }
+    return *_index;
+}
+
 bool TextDB::_needs_update() const
 {
     string ts;
@@ -300,6 +392,13 @@ void TextDB::_regenerate_db()
     unlink_u(full_db_path.c_str());
 #endif
 
+    _build_db(db_path);
+}
+
+// Parse the input files into a new database at db_path, and return its
+// timestamp.
+string TextDB::_build_db(const string &db_path)
+{
     string ts;
     if (!(_db = dbm_open(db_path.c_str(), O_RDWR | O_CREAT, 0660)))
         end(1, true, "Unable to open DB: %s", db_path.c_str());
@@ -321,6 +420,90 @@ void TextDB::_regenerate_db()
 
     dbm_close(_db);
     _db = 0;
+    return ts;
+}
+
+bool TextDB::_has_input_files() const
+{
+    for (const string &file : _input_files)
+        if (!datafile_path(_directory + file, false).empty())
+            return true;
+    return false;
+}
+
+// Use the database built along with the game (see prebuild()) if there is
+// one for this version. Its source files are never checked, so starting a
+// game doesn't have to stat, parse or write anything.
+bool TextDB::_open_prebuilt()
+{
+    const string db_path = datafile_path(
+        "db/" + _db_prebuilt_name(_db_name, lang()), false);
+    if (db_path.empty())
+        return false;
+
+#ifdef USE_SQLITE_DBM
+    if (!(_db = dbm_open_immutable(db_path.c_str())))
+        return false;
+#else
+    // Other DBMs add their own extensions, so the name won't match.
+    return false;
+#endif
+
+    datum dbKey;
+    dbKey.dptr = (DPTR_COERCE) DB_VERSION_KEY;
+    dbKey.dsize = strlen(DB_VERSION_KEY);
+    datum result = dbm_fetch(_db, dbKey);
+    if (result.dptr && string((const char *)result.dptr, result.dsize)
+                       == Version::Long)
+    {
+        return true;
+    }
+
+    dprf("Ignoring prebuilt db from another version: %s", db_path.c_str());
+    shutdown();
+    return false;
+}
+
+// Write this database, and all of its translations, to dir for installing
+// alongside the game data.
+void TextDB::prebuild(const string &dir)
+{
+    ASSERT(!_parent);
+
+    string db_path = catpath(dir, _db_prebuilt_name(_db_name, nullptr));
+    unlink_u(db_path.c_str());
+    printf("Building db: %s\n", db_path.c_str());
+    _build_db(db_path);
+    string version = Version::Long;
+    if (!(_db = dbm_open(db_path.c_str(), O_RDWR, 0660)))
+        end(1, true, "Unable to open DB: %s", db_path.c_str());
+    _add_entry(_db, DB_VERSION_KEY, version);
+    shutdown();
+
+    // Any subdirectory of our input directory is a translation.
+    const string input_dir = datafile_path(_directory, false, false,
+                                           dir_exists);
+    if (input_dir.empty())
+        return;
+    for (const string &lang : get_dir_files_sorted(input_dir))
+    {
+        if (!dir_exists(catpath(input_dir, lang)))
+            continue;
+
+        unwind_var<const char *> lang_name(Options.lang_name, lang.c_str());
+        TextDB tr(this);
+        if (!tr._has_input_files())
+            continue;
+
+        db_path = catpath(dir, _db_prebuilt_name(_db_name, lang.c_str()));
+        unlink_u(db_path.c_str());
+        printf("Building db: %s\n", db_path.c_str());
+        tr._build_db(db_path);
+        if (!(tr._db = dbm_open(db_path.c_str(), O_RDWR, 0660)))
+            end(1, true, "Unable to open DB: %s", db_path.c_str());
+        _add_entry(tr._db, DB_VERSION_KEY, version);
+        tr.shutdown();
+    }
 }
 
 // ----------------------------------------------------------------------
@@ -335,6 +518,18 @@ void databaseSystemInit()
         AllDBs[i].init();
 }
 
+void databasePrebuild(const string &dir)
+{
+#ifndef USE_SQLITE_DBM
+    end(1, false, "Prebuilt databases need a SQLite build.");
+#endif
+    string out_dir = dir;
+    if (!check_mkdir("DB directory", &out_dir))
+        end(1, false, "Cannot create db directory '%s'.", dir.c_str());
+    for (unsigned int i = 0; i < NUM_DB; i++)
+        AllDBs[i].prebuild(out_dir);
+}
+
 void databaseSystemShutdown()
 {
     for (unsigned int i = 0; i < NUM_DB; i++)
@@ -361,7 +556,56 @@ static datum _database_fetch(DBM *database, const string &key)
     return result;
 }
 
-static vector<string> _database_find_keys(DBM *database,
+// Can the index answer a search for this pattern? Only case-insensitive
+// searches for plain ASCII strings are indexed; anything with regex syntax
+// falls back to scanning the database.
+static bool _is_indexable_pattern(const string &regex, bool ignore_case)
+{
+    if (!ignore_case)
+        return false;
+    for (const char c : regex)
+        if ((unsigned char)c >= 0x80 || strchr("\\^$.|?*+()[]{}", c))
+            return false;
+    return true;
+}
+
+// Find the entries that might contain a literal search string: those with,
+// for every word of the search, some word containing it. (The first and last
+// words of the search may only be parts of words in the entry.) Returns false
+// if the search has no words to look up.
+static bool _index_candidates(const map<string, vector<int>> &index,
+                              const string &search, vector<int> &candidates)
+{
+    const vector<string> search_words = _db_words(search.c_str(),
+                                                  search.length());
+    if (search_words.empty())
+        return false;
+
+    for (unsigned int i = 0; i < search_words.size(); ++i)
+    {
+        vector<int> hits;
+        for (const auto &entry : index)
+            if (entry.first.find(search_words[i]) != string::npos)
+                hits.insert(hits.end(), entry.second.begin(), entry.second.end());
+        sort(hits.begin(), hits.end());
+        hits.erase(unique(hits.begin(), hits.end()), hits.end());
+
+        if (i == 0)
+            candidates.swap(hits);
+        else
+        {
+            vector<int> both;
+            set_intersection(candidates.begin(), candidates.end(),
+                             hits.begin(), hits.end(), back_inserter(both));
+            candidates.swap(both);
+        }
+        if (candidates.empty())
+            break;
+    }
+    return true;
+}
+
+static vector<string> _database_find_keys(TextDB &db,
                                           const string &regex,
                                           bool ignore_case,
                                           db_find_filter filter = nullptr)
@@ -369,39 +613,51 @@ static vector<string> _database_find_keys(DBM *database,
     text_pattern             tpat(regex, ignore_case);
     vector<string> matches;
 
-    datum dbKey = dbm_firstkey(database);
-
-    while (dbKey.dptr != nullptr)
+    auto check_key = [&](const string &key)
     {
-        string key((const char *)dbKey.dptr, dbKey.dsize);
-
         if (tpat.matches(key)
             && key.find("__") == string::npos
             && (filter == nullptr || !(*filter)(key, "")))
         {
             matches.push_back(key);
         }
+    };
+
+    vector<int> candidates;
+    if (_is_indexable_pattern(regex, ignore_case))
+    {
+        const db_word_index &index = db.word_index();
+        if (_index_candidates(index.key_words, regex, candidates))
+        {
+            for (int entry : candidates)
+                check_key(index.keys[entry]);
+            return matches;
+        }
+    }
+
+    DBM *database = db.get();
+    datum dbKey = dbm_firstkey(database);
 
+    while (dbKey.dptr != nullptr)
+    {
+        check_key(string((const char *)dbKey.dptr, dbKey.dsize));
         dbKey = dbm_nextkey(database);
     }
 
     return matches;
 }
 
-static vector<string> _database_find_bodies(DBM *database,
+static vector<string> _database_find_bodies(TextDB &db,
                                             const string &regex,
                                             bool ignore_case,
                                             db_find_filter filter = nullptr)
 {
     text_pattern             tpat(regex, ignore_case);
     vector<string> matches;
+    DBM *database = db.get();
 
-    datum dbKey = dbm_firstkey(database);
-
-    while (dbKey.dptr != nullptr)
+    auto check_entry = [&](const string &key, datum dbKey)
     {
-        string key((const char *)dbKey.dptr, dbKey.dsize);
-
         datum dbBody = dbm_fetch(database, dbKey);
         string body((const char *)dbBody.dptr, dbBody.dsize);
 
@@ -411,7 +667,32 @@ static vector<string> _database_find_bodies(DBM *database,
         {
             matches.push_back(key);
         }
+    };
+
+    vector<int> candidates;
+    if (_is_indexable_pattern(regex, ignore_case))
+    {
+        const db_word_index &index = db.word_index();
+        if (_index_candidates(index.body_words, regex, candidates))
+        {
+            for (int entry : candidates)
+            {
+                const string &key = index.keys[entry];
+                datum dbKey;
+                dbKey.dptr = (DPTR_COERCE) key.c_str();
+                dbKey.dsize = key.length();
+                check_entry(key, dbKey);
+            }
+            return matches;
+        }
+    }
+
+    datum dbKey = dbm_firstkey(database);
 
+    while (dbKey.dptr != nullptr)
+    {
+        string key((const char *)dbKey.dptr, dbKey.dsize);
+        check_entry(key, dbKey);
         dbKey = dbm_nextkey(database);
     }
 
@@ -791,7 +1072,7 @@ vector<string> getLongDescKeysByRegex(const string &regex,
 
     // FIXME: need to match regex against translated keys, which can't
     // be done by db only.
-    return _database_find_keys(DescriptionDB.get(), regex, true, filter);
+    return _database_find_keys(DescriptionDB, regex, true, filter);
 }
 
 vector<string> getLongDescBodiesByRegex(const string &regex,
@@ -807,8 +1088,8 @@ vector<string> getLongDescBodiesByRegex(const string &regex,
     // Not good, but otherwise we'd have to check hundreds of keys, with
     // two queries for each.
     // SQL can do this in one go, DBM can't.
-    DBM *database = DescriptionDB.translation ?
-        DescriptionDB.translation->get() : DescriptionDB.get();
+    TextDB &database = DescriptionDB.translation ? *DescriptionDB.translation
+                                                 : DescriptionDB;
     return _database_find_bodies(database, regex, true, filter);
 }
 
@@ -880,7 +1161,7 @@ vector<string> getAllFAQKeys()
         return empty;
     }
 
-    return _database_find_keys(FAQDB.get(), "^q.+", false);
+    return _database_find_keys(FAQDB, "^q.+", false);
 }
 
 string getFAQ_Question(const string &key)
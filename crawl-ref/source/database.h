@@ -28,6 +28,7 @@ extern "C" {
 #define DPTR_COERCE char *
 
 void databaseSystemInit();
+void databasePrebuild(const string &dir);
 void databaseSystemShutdown();
 
 typedef bool (*db_find_filter)(string key, string body);
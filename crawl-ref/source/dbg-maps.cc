@@ -7,6 +7,12 @@
 
 #include "dbg-maps.h"
 
+#include <cinttypes>
+#ifdef UNIX
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #include "branch.h"
 #include "chardump.h"
 #include "crash.h"
@@ -19,12 +25,15 @@
 #include "maps.h"
 #include "message.h"
 #include "ng-init.h"
+#include "options.h"
 #include "player.h"
+#include "random.h"
 #include "shopping.h"
 #include "state.h"
 #include "stringutil.h"
 #include "syscalls.h"
 #include "tag-version.h"
+#include "tags.h"
 #include "view.h"
 
 #ifdef DEBUG_STATISTICS
@@ -49,6 +58,10 @@ static int build_attempts = 0, level_vetoes = 0;
 // Map from message to counts.
 static map<string, int> veto_messages;
 
+// Iteration i is seeded with this plus i, so the stats don't depend on how
+// iterations are shared out between -jobs processes.
+static uint64_t iteration_seed_base = 0;
+
 void mapstat_report_map_build_start()
 {
     build_attempts++;
@@ -220,6 +233,238 @@ static bool _build_dungeon()
     return true;
 }
 
+/**
+ * Build iteration i of mapstat or objstat: reseed from the base seed, reset
+ * the state that carries from one game's levels to the next (unique vaults
+ * and monsters, item sets, branch depths), then build every chosen level.
+ *
+ * @param i The iteration, from 0; its seed is iteration_seed_base + i.
+ * @returns False if a level failed to build, in which case the caller
+ *          should stop; see mapstat_build_levels().
+ */
+static bool _build_iteration(int i)
+{
+    clear_messages();
+    mprf("On %d of %d; %d g, %d fail, %u err%s, %u uniq, "
+         "%d try, %d (%.2f%%) vetoes",
+         i, SysEnv.map_gen_iters, levels_tried, levels_failed,
+         (unsigned int)errors.size(),
+         last_error.empty() ? "" : (" (" + last_error + ")").c_str(),
+         (unsigned int)use_count.size(), build_attempts, level_vetoes,
+         build_attempts ? level_vetoes * 100.0 / build_attempts : 0.0);
+    printf("%d..", i + 1);
+    fflush(stdout);
+    rng::seed(iteration_seed_base + i);
+    dlua.callfn("dgn_clear_data", "");
+    you.uniq_map_tags.clear();
+    you.uniq_map_names.clear();
+    you.uniq_map_tags_abyss.clear();
+    you.uniq_map_names_abyss.clear();
+    you.unique_creatures.reset();
+    you.generated_misc.clear();
+    initialise_item_sets(true);
+    initialise_branch_depths();
+    init_level_connectivity();
+    if (!_build_dungeon())
+        return false;
+    if (crawl_state.obj_stat_gen)
+        objstat_iteration_stats();
+    return true;
+}
+
+#ifdef UNIX
+// Passing stats from -jobs processes back to the parent, which adds them up.
+
+static void _marshall_stat(writer &th, int n)
+{
+    marshallInt(th, n);
+}
+
+static void _marshall_stat(writer &th, const string &s)
+{
+    marshallString(th, s);
+}
+
+static void _marshall_stat(writer &th, const level_id &lid)
+{
+    marshall_level_id(th, lid);
+}
+
+static void _marshall_stat(writer &th, const pair<int, int> &p)
+{
+    marshallInt(th, p.first);
+    marshallInt(th, p.second);
+}
+
+template <typename T>
+static void _marshall_stat(writer &th, const set<T> &values)
+{
+    marshallInt(th, values.size());
+    for (const T &value : values)
+        _marshall_stat(th, value);
+}
+
+template <typename K, typename V>
+static void _marshall_stat(writer &th, const map<K, V> &values)
+{
+    marshallInt(th, values.size());
+    for (const auto &entry : values)
+    {
+        _marshall_stat(th, entry.first);
+        _marshall_stat(th, entry.second);
+    }
+}
+
+static void _unmarshall_stat(reader &th, int &n)
+{
+    n += unmarshallInt(th);
+}
+
+static void _unmarshall_stat(reader &th, string &s)
+{
+    s = unmarshallString(th);
+}
+
+static void _unmarshall_stat(reader &th, level_id &lid)
+{
+    lid = unmarshall_level_id(th);
+}
+
+static void _unmarshall_stat(reader &th, pair<int, int> &p)
+{
+    p.first += unmarshallInt(th);
+    p.second += unmarshallInt(th);
+}
+
+template <typename T>
+static void _unmarshall_stat(reader &th, set<T> &values)
+{
+    for (int i = unmarshallInt(th); i > 0; --i)
+    {
+        T value;
+        _unmarshall_stat(th, value);
+        values.insert(value);
+    }
+}
+
+// Adds the values read to those already in the map.
+template <typename K, typename V>
+static void _unmarshall_stat(reader &th, map<K, V> &values)
+{
+    for (int i = unmarshallInt(th); i > 0; --i)
+    {
+        K key;
+        _unmarshall_stat(th, key);
+        _unmarshall_stat(th, values[key]);
+    }
+}
+
+static void _write_job_stats(writer &th)
+{
+    _marshall_stat(th, levels_tried);
+    _marshall_stat(th, levels_failed);
+    _marshall_stat(th, build_attempts);
+    _marshall_stat(th, level_vetoes);
+    _marshall_stat(th, last_error);
+    _marshall_stat(th, try_count);
+    _marshall_stat(th, use_count);
+    _marshall_stat(th, success_count);
+    _marshall_stat(th, level_mapcounts);
+    _marshall_stat(th, map_builds);
+    _marshall_stat(th, level_mapsused);
+    _marshall_stat(th, map_levelsused);
+    _marshall_stat(th, veto_messages);
+}
+
+static void _read_job_stats(reader &th)
+{
+    _unmarshall_stat(th, levels_tried);
+    _unmarshall_stat(th, levels_failed);
+    _unmarshall_stat(th, build_attempts);
+    _unmarshall_stat(th, level_vetoes);
+    string error;
+    _unmarshall_stat(th, error);
+    if (!error.empty())
+        last_error = error;
+    _unmarshall_stat(th, try_count);
+    _unmarshall_stat(th, use_count);
+    _unmarshall_stat(th, success_count);
+    _unmarshall_stat(th, level_mapcounts);
+    _unmarshall_stat(th, map_builds);
+    _unmarshall_stat(th, level_mapsused);
+    _unmarshall_stat(th, map_levelsused);
+    _unmarshall_stat(th, veto_messages);
+}
+
+/**
+ * Build the iterations in several processes, each with its own copy of the
+ * dungeon, then add up their stats. Job j builds iterations j, j + jobs, ...
+ * Since every iteration reseeds and resets the cross-level state first, the
+ * totals match what a single process would get for the same seed.
+ */
+static bool _build_iterations_in_jobs(int jobs)
+{
+    // Don't let the children inherit anything waiting to be written.
+    fflush(stdout);
+    fflush(stderr);
+
+    vector<pair<pid_t, int>> children;
+    for (int job = 0; job < jobs; ++job)
+    {
+        int fds[2];
+        if (pipe(fds) < 0)
+            end(1, true, "Can't create a pipe for mapstat jobs");
+
+        const pid_t pid = fork();
+        if (pid < 0)
+            end(1, true, "Can't start mapstat job");
+        if (pid == 0)
+        {
+            close(fds[0]);
+            for (const auto &child : children)
+                close(child.second);
+
+            bool ok = true;
+            for (int i = job; ok && i < SysEnv.map_gen_iters; i += jobs)
+                ok = _build_iteration(i);
+
+            FILE *out = fdopen(fds[1], "wb");
+            writer outf("mapstat job", out, true);
+            _write_job_stats(outf);
+            ok = outf.succeeded() && !fclose(out) && ok;
+            fflush(stdout);
+            _exit(ok ? 0 : 1);
+        }
+        close(fds[1]);
+        children.emplace_back(pid, fds[0]);
+    }
+
+    bool ok = true;
+    for (const auto &child : children)
+    {
+        FILE *in = fdopen(child.second, "rb");
+        try
+        {
+            reader inf(in);
+            _read_job_stats(inf);
+        }
+        catch (short_read_exception &E)
+        {
+            ok = false;
+        }
+        fclose(in);
+
+        int status;
+        if (waitpid(child.first, &status, 0) < 0 || !WIFEXITED(status)
+            || WEXITSTATUS(status))
+        {
+            ok = false;
+        }
+    }
+    return ok;
+}
+#endif
+
 /**
  * Build dungeon levels for mapstat or objstat.
  *
@@ -237,35 +482,27 @@ bool mapstat_build_levels()
 {
     if (!generated_levels.size())
         _dungeon_places();
+
+    iteration_seed_base = Options.seed ? Options.seed : rng::get_uint64();
+    printf("Seed: %" PRIu64 "\n", iteration_seed_base);
     printf("Iteration: ");
     fflush(stdout);
-    for (int i = 0; i < SysEnv.map_gen_iters; ++i)
+
+#ifdef UNIX
+    // objstat keeps far more state than mapstat; it still runs in one
+    // process.
+    const int jobs = min(SysEnv.map_gen_jobs, SysEnv.map_gen_iters);
+    if (jobs > 1 && !crawl_state.obj_stat_gen)
     {
-        clear_messages();
-        mprf("On %d of %d; %d g, %d fail, %u err%s, %u uniq, "
-             "%d try, %d (%.2f%%) vetoes",
-             i, SysEnv.map_gen_iters, levels_tried, levels_failed,
-             (unsigned int)errors.size(),
-             last_error.empty() ? "" : (" (" + last_error + ")").c_str(),
-             (unsigned int)use_count.size(), build_attempts, level_vetoes,
-             build_attempts ? level_vetoes * 100.0 / build_attempts : 0.0);
-        printf("%d..", i + 1);
-        fflush(stdout);
-        dlua.callfn("dgn_clear_data", "");
-        you.uniq_map_tags.clear();
-        you.uniq_map_names.clear();
-        you.uniq_map_tags_abyss.clear();
-        you.uniq_map_names_abyss.clear();
-        you.unique_creatures.reset();
-        you.generated_misc.clear();
-        initialise_item_sets(true);
-        initialise_branch_depths();
-        init_level_connectivity();
-        if (!_build_dungeon())
+        if (!_build_iterations_in_jobs(jobs))
             return false;
-        if (crawl_state.obj_stat_gen)
-            objstat_iteration_stats();
     }
+    else
+#endif
+    for (int i = 0; i < SysEnv.map_gen_iters; ++i)
+        if (!_build_iteration(i))
+            return false;
+
     printf("Finished.\n");
     fflush(stdout);
     return true;
@@ -372,7 +609,7 @@ static void _write_map_stats()
     {
         const map_def *map = map_by_index(i);
         if (!try_count.count(map->name)
-            && !map->has_tag("dummy"))
+            && !map->has_tag(MAP_TAG_DUMMY))
         {
             unused_maps.push_back(map->name);
         }
@@ -57,8 +57,11 @@ void debug_item_scan()
 
         // Looking for infinite stacks (ie more links than items allowed)
         // and for items which have bad coordinates (can't find their stack)
+        int stack_size = 0;
         for (int obj = env.igrid(*ri); obj != NON_ITEM; obj = env.item[obj].link)
         {
+            ++stack_size;
+
             if (obj < 0 || obj > MAX_ITEMS)
             {
                 if (env.igrid(*ri) == obj)
@@ -100,6 +103,14 @@ void debug_item_scan()
             }
             visited.set(obj);
         }
+
+        // Check that the floor item index agrees with the stack.
+        if (floor_item_count(*ri) != stack_size)
+        {
+            mprf(MSGCH_ERROR, "Floor item index has %d items at (%d, %d), "
+                              "but the stack has %d",
+                 floor_item_count(*ri), ri->x, ri->y, stack_size);
+        }
     }
 
     // Now scan all the items on the level:
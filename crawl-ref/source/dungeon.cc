@@ -835,19 +835,19 @@ static void _set_grd(const coord_def &c, dungeon_feature_type feat)
     env.grid(c) = feat;
 }
 
-static void _dgn_register_vault(const string &name, const unordered_set<string> &tags)
+static void _dgn_register_vault(const string &name, const map_tag_set &tags)
 {
-    if (!tags.count("allow_dup"))
+    if (!tags.contains(MAP_TAG_ALLOW_DUP))
         get_uniq_map_names().insert(name);
 
-    if (tags.count("luniq"))
+    if (tags.contains(MAP_TAG_LUNIQ))
         env.level_uniq_maps.insert(name);
 
-    vector<string> sorted_tags(tags.begin(), tags.end());
-    sort(sorted_tags.begin(), sorted_tags.end());
-
-    for (const string &tag : sorted_tags)
+    for (map_tag_id tag_id : tags)
     {
+        if (!map_tag_is_uniq(tag_id))
+            continue;
+        const string &tag = map_tag_name(tag_id);
         if (starts_with(tag, "uniq_"))
             get_uniq_map_tags().insert(tag);
         else if (starts_with(tag, "luniq_"))
@@ -857,12 +857,12 @@ static void _dgn_register_vault(const string &name, const unordered_set<string>
 
 static void _dgn_register_vault(const map_def &map)
 {
-    _dgn_register_vault(map.name, map.get_tags_unsorted());
+    _dgn_register_vault(map.name, map.get_tag_ids());
 }
 
 static void _dgn_register_vault(const string &name, string &spaced_tags)
 {
-    _dgn_register_vault(name, parse_tags(spaced_tags));
+    _dgn_register_vault(name, parse_map_tags(spaced_tags));
 }
 
 static void _dgn_unregister_vault(const map_def &map)
@@ -870,8 +870,11 @@ static void _dgn_unregister_vault(const map_def &map)
     get_uniq_map_names().erase(map.name);
     env.level_uniq_maps.erase(map.name);
 
-    for (const string &tag : map.get_tags_unsorted())
+    for (map_tag_id tag_id : map.get_tag_ids())
     {
+        if (!map_tag_is_uniq(tag_id))
+            continue;
+        const string &tag = map_tag_name(tag_id);
         if (starts_with(tag, "uniq_"))
             get_uniq_map_tags().erase(tag);
         else if (starts_with(tag, "luniq_"))
@@ -1358,9 +1361,9 @@ dgn_register_place(const vault_placement &place, bool register_vault)
     }
 
     // Find tags matching properties.
-    for (const auto &tag : place.map.get_tags_unsorted())
+    for (map_tag_id tag : place.map.get_tag_ids())
     {
-        const feature_property_type prop = str_to_fprop(tag);
+        const feature_property_type prop = str_to_fprop(map_tag_name(tag));
         if (prop == FPROP_NONE)
             continue;
 
@@ -1576,7 +1579,7 @@ void dgn_reset_level(bool enable_random_maps)
     env.cloud.clear();
 
     env.mgrid.init(NON_MONSTER);
-    env.igrid.init(NON_ITEM);
+    clear_item_grid();
 
     // Reset all shops.
     env.shop.clear();
@@ -4513,7 +4516,7 @@ static const vault_placement *_build_vault_impl(const map_def *vault,
             throw dgn_veto_exception("Pan map with disconnected zones");
     }
 
-    if (crawl_state.game_is_descent() && vault->get_tags_unsorted().count("no_descent"))
+    if (crawl_state.game_is_descent() && vault->has_tag(MAP_TAG_NO_DESCENT))
         throw dgn_veto_exception("Illegal map for descent");
 
     unwind_var<string> placing(env.placing_vault, vault->name);
@@ -35,6 +35,7 @@
 #include "stringutil.h"
 #include "tag-version.h"
 #include "tilepick.h"
+#include "turn-profile.h"
 #include "view.h"
 #include "xom.h"
 #include "ui.h"
@@ -291,10 +292,6 @@ NORETURN void end_game(scorefile_entry &se)
         hiscore_index = hiscores_new_entry(se);
         logfile_new_entry(se);
     }
-#ifndef SCORE_WIZARD_CHARACTERS
-    else
-        hiscores_read_to_memory();
-#endif
 
     // Never generate bones files of wizard or tutorial characters -- bwr
     if (!non_death && !crawl_state.game_is_tutorial() && !you.wizard)
@@ -315,6 +312,10 @@ NORETURN void end_game(scorefile_entry &se)
     else
         tiles.send_dump_info("morgue", fname);
 #endif
+#ifdef DEBUG_TURN_PROFILE
+    turn_profile_write(morgue_directory()
+                       + strip_filename_unsafe_chars(fname) + ".prof");
+#endif
 
     const game_exit exit_reason = _kill_method_to_exit(death_type);
 #if defined(DGL_WHEREIS) || defined(USE_TILE_WEB)
@@ -139,6 +139,8 @@ static bool _ghost_version_compatible(const save_version &version);
 static bool _restore_tagged_chunk(package *save, const string &name,
                                   tag_type tag, const char* complaint);
 static player_save_info _read_character_info(package *save);
+static player_save_info _read_character_info(reader &inf,
+                                             const string &filename);
 
 static bool _convert_obsolete_species();
 
@@ -705,7 +707,8 @@ static bool _readln(chunk_reader &rd, char *buf)
     return true;
 }
 
-static void _fill_player_doll(player_save_info &p, package *save)
+// parts is the doll line from the save, or nullptr if it couldn't be read.
+static void _fill_player_doll(player_save_info &p, const char *parts)
 {
     dolls_data equip_doll;
     for (unsigned int j = 0; j < TILEP_PART_MAX; ++j)
@@ -714,20 +717,14 @@ static void _fill_player_doll(player_save_info &p, package *save)
     equip_doll.parts[TILEP_PART_BASE]
         = tilep_species_to_base_tile(p.species, p.experience_level);
 
-    bool success = false;
-
-    chunk_reader fdoll(save, "tdl");
+    if (parts)
     {
         char fbuf[LINEMAX];
-        if (_readln(fdoll,fbuf))
-        {
-            tilep_scan_parts(fbuf, equip_doll, p.species, p.experience_level);
-            tilep_race_default(p.species, p.experience_level, &equip_doll);
-            success = true;
-        }
+        snprintf(fbuf, sizeof(fbuf), "%s", parts);
+        tilep_scan_parts(fbuf, equip_doll, p.species, p.experience_level);
+        tilep_race_default(p.species, p.experience_level, &equip_doll);
     }
-
-    if (!success) // Use default doll instead.
+    else // Use default doll instead.
     {
         job_type job = get_job_by_name(p.class_name.c_str());
         if (job == JOB_UNKNOWN)
@@ -737,7 +734,145 @@ static void _fill_player_doll(player_save_info &p, package *save)
     }
     p.doll = equip_doll;
 }
+
+static void _fill_player_doll(player_save_info &p, package *save)
+{
+    chunk_reader fdoll(save, "tdl");
+    char fbuf[LINEMAX];
+    _fill_player_doll(p, _readln(fdoll, fbuf) ? fbuf : nullptr);
+}
+#endif
+
+/*
+ * Save summaries: a small file next to each save, written when the game is
+ * saved and exited, holding what the saved game lists need. Reading one is
+ * much cheaper than opening the save itself. A summary only counts if the
+ * save's size and modification time still match the ones it records, and
+ * it's deleted when the save is opened for play, so a save in use or one
+ * changed since never gets listed from a summary.
+ */
+#define SAVE_SUMMARY_MAGIC   0x4d555343 // "CSUM"
+#define SAVE_SUMMARY_VERSION 1
+#define SAVE_SUMMARY_SUFFIX  ".summary"
+
+static bool _save_file_stat(const string &save_path, int64_t &size,
+                            int64_t &mtime)
+{
+    struct stat st;
+    if (stat(save_path.c_str(), &st))
+        return false;
+    size = st.st_size;
+    mtime = st.st_mtime;
+    return true;
+}
+
+// The character info from the current save, and its doll line if any.
+static void _save_summary_data(vector<unsigned char> &chr, string &doll)
+{
+    writer chrf(&chr);
+    write_save_version(chrf, save_version::current());
+    tag_write(TAG_CHR, chrf);
+
+#ifdef USE_TILE
+    vector<unsigned char> dollbuf;
+    writer dollf(&dollbuf);
+    save_doll_file(dollf);
+    doll.assign(dollbuf.begin(), dollbuf.end());
+    // As _readln() would leave it.
+    if (!doll.empty() && doll.back() == '\n')
+        doll.pop_back();
+#else
+    UNUSED(doll);
+#endif
+}
+
+static void _write_save_summary(const string &save_path,
+                                const vector<unsigned char> &chr,
+                                const string &doll)
+{
+    int64_t size, mtime;
+    if (!_save_file_stat(save_path, size, mtime))
+        return;
+
+    const string filename = save_path + SAVE_SUMMARY_SUFFIX;
+    const string tmpname = filename + ".tmp";
+    FILE *summaryf = fopen_replace(tmpname.c_str());
+    if (!summaryf)
+        return;
+
+    writer outf(tmpname, summaryf, true);
+    marshallInt(outf, SAVE_SUMMARY_MAGIC);
+    marshallInt(outf, SAVE_SUMMARY_VERSION);
+    marshallSigned(outf, size);
+    marshallSigned(outf, mtime);
+    marshallInt(outf, chr.size());
+    outf.write(chr.data(), chr.size());
+#ifdef USE_TILE
+    marshallBoolean(outf, true);
+#else
+    marshallBoolean(outf, false);
+#endif
+    marshallString(outf, doll);
+
+    const bool ok = outf.succeeded() && !fclose(summaryf);
+    if (!ok || rename_u(tmpname.c_str(), filename.c_str()))
+        unlink_u(tmpname.c_str());
+}
+
+static void _remove_save_summary(const string &save_path)
+{
+    unlink_u((save_path + SAVE_SUMMARY_SUFFIX).c_str());
+}
+
+// Fill p from save_path's summary, if it has an up to date one.
+static bool _read_save_summary(const string &save_path, player_save_info &p)
+{
+    FILE *summaryf = fopen_u((save_path + SAVE_SUMMARY_SUFFIX).c_str(), "rb");
+    if (!summaryf)
+        return false;
+
+    bool ok = false;
+    try
+    {
+        reader inf(summaryf);
+        inf.set_safe_read(true);
+        int64_t size, mtime;
+        if (unmarshallInt(inf) == SAVE_SUMMARY_MAGIC
+            && unmarshallInt(inf) == SAVE_SUMMARY_VERSION
+            && _save_file_stat(save_path, size, mtime)
+            && unmarshallSigned(inf) == size
+            && unmarshallSigned(inf) == mtime)
+        {
+            const int len = unmarshallInt(inf);
+            if (len > 0 && len <= 4096)
+            {
+                vector<unsigned char> chr(len);
+                inf.read(chr.data(), len);
+                reader chrf(chr);
+                p = _read_character_info(chrf, save_path);
+
+                const bool has_doll = unmarshallBoolean(inf);
+                const string doll = unmarshallString(inf);
+#ifdef USE_TILE
+                if (Options.tile_menu_icons && has_doll)
+                    _fill_player_doll(p, doll.empty() ? nullptr : doll.c_str());
+#else
+                UNUSED(has_doll);
 #endif
+                ok = true;
+            }
+        }
+    }
+    catch (short_read_exception &E)
+    {
+    }
+    catch (ext_fail_exception &E)
+    {
+        dprf("%s: %s", save_path.c_str(), E.what());
+    }
+    fclose(summaryf);
+    return ok;
+}
 
 /*
  * Returns a list of the names of characters that are already saved for the
@@ -763,15 +898,23 @@ static vector<player_save_info> _find_saved_characters()
         {
             try
             {
-                package save(_get_savedir_path(filename).c_str(), false);
-                player_save_info p = _read_character_info(&save);
-                if (!p.name.empty())
+                const string save_path = _get_savedir_path(filename);
+                player_save_info p;
+                if (!_read_save_summary(save_path, p))
                 {
-                    p.filename = filename;
+                    package save(save_path.c_str(), false);
+                    p = _read_character_info(&save);
 #ifdef USE_TILE
-                    if (Options.tile_menu_icons && save.has_chunk("tdl"))
+                    if (!p.name.empty() && Options.tile_menu_icons
+                        && save.has_chunk("tdl"))
+                    {
                         _fill_player_doll(p, &save);
+                    }
 #endif
+                }
+                if (!p.name.empty())
+                {
+                    p.filename = filename;
                     chars.push_back(p);
                 }
             }
@@ -860,8 +1003,12 @@ static bool _append_save_info(JsonWrapper &json, const char *filename,
         return false;
     try
     {
-        package save(filename, false);
-        player_save_info p = _read_character_info(&save);
+        player_save_info p;
+        if (!_read_save_summary(filename, p))
+        {
+            package save(filename, false);
+            p = _read_character_info(&save);
+        }
 
         // TODO: some json for the non-loadable case? I think this comes up
         // for save compat mismatches so shouldn't be relevant for webtiles
@@ -941,7 +1088,8 @@ NORETURN void print_save_json(const char *name)
 {
     // TODO: The overall call is quite heavy. Can the overhead to get to this
     // point be simplified at all? On my local machine it's about 80-100ms per
-    // call if things go well.
+    // call if things go well, though a fresh save summary avoids opening the
+    // save itself.
     try
     {
         JsonWrapper json(json_mkobject());
@@ -1851,6 +1999,11 @@ static const vector<branch_type> branch_generation_order =
     NUM_BRANCHES,
 };
 
+const vector<branch_type> &pregen_branch_order()
+{
+    return branch_generation_order;
+}
+
 static bool _branch_pregenerates(branch_type b)
 {
     if (!you.deterministic_levelgen)
@@ -2596,8 +2749,18 @@ static void _save_game_exit()
     tiles.send_exit_reason("saved");
 #endif
 
+    const string save_path = you.save->get_filename();
+    vector<unsigned char> chr;
+    string doll;
+    if (!Options.no_save)
+        _save_summary_data(chr, doll);
+
     delete you.save;
     you.save = 0;
+
+    // Only now is the save file in its final state.
+    if (!Options.no_save)
+        _write_save_summary(save_path, chr, doll);
 }
 
 void save_game(bool leave_game, const char *farewellmsg)
@@ -3174,6 +3337,8 @@ static bool _restore_game(const string& filename)
     clear_message_store();
 
     you.save = new package((_get_savefile_directory() + filename).c_str(), true);
+    // The save is about to change, and is locked while it's in play.
+    _remove_save_summary(you.save->get_filename());
 
     player_save_info save_info = _read_character_info(you.save);
     if (!save_info.save_loadable)
@@ -3541,7 +3706,12 @@ static bool _loadable_save_ver(int major, int minor)
 static player_save_info _read_character_info(package *save)
 {
     reader inf(save, "chr");
+    return _read_character_info(inf, save->get_filename());
+}
 
+static player_save_info _read_character_info(reader &inf,
+                                             const string &filename)
+{
     try
     {
         player_save_info result;
@@ -3551,7 +3721,7 @@ static player_save_info _read_character_info(package *save)
 
         unsigned int len = unmarshallInt(inf);
         if (len > 1024) // something is fishy
-            fail("Save file `%s` corrupted (info > 1KB)", save->get_filename().c_str());
+            fail("Save file `%s` corrupted (info > 1KB)", filename.c_str());
         vector<unsigned char> buf;
         buf.resize(len);
         inf.read(&buf[0], len);
@@ -3567,7 +3737,7 @@ static player_save_info _read_character_info(package *save)
         if (format > TAG_CHR_FORMAT)
         {
             fail("Incompatible character data from the future in `%s`",
-                                        save->get_filename().c_str());
+                                        filename.c_str());
         }
 
         result = tag_read_char_info(th, format, major, minor);
@@ -3582,7 +3752,7 @@ static player_save_info _read_character_info(package *save)
     }
     catch (short_read_exception &E)
     {
-        fail("Save file `%s` corrupted (short read)", save->get_filename().c_str());
+        fail("Save file `%s` corrupted (short read)", filename.c_str());
     };
 }
 
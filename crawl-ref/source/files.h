@@ -11,6 +11,7 @@
 #include <string>
 #include <vector>
 
+#include "branch-type.h"
 #include "maybe-bool.h"
 
 struct player_save_info;
@@ -91,6 +92,7 @@ void update_portal_entrances();
 void reset_portal_entrances();
 bool generate_level(const level_id &l);
 bool pregen_dungeon(const level_id &stopping_point);
+const vector<branch_type> &pregen_branch_order();
 bool load_level(dungeon_feature_type stair_taken, load_mode_type load_mode,
                 const level_id& old_level);
 void delete_level(const level_id &level);
@@ -667,14 +667,14 @@ void gozag_count_level_gold()
     ASSERT(you.on_current_level);
     vector<coord_def> gold_places;
     int gold = 0;
-    for (rectangle_iterator ri(0); ri; ++ri)
+    for (const coord_def &pos : floor_item_cells())
     {
-        for (stack_iterator j(*ri); j; ++j)
+        for (stack_iterator j(pos); j; ++j)
         {
             if (j->base_type == OBJ_GOLD && !(j->flags & ISFLAG_UNOBTAINABLE))
             {
                 gold += j->quantity;
-                gold_places.push_back(*ri);
+                gold_places.push_back(pos);
             }
         }
     }
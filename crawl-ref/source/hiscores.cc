@@ -16,12 +16,17 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cerrno>
 #include <cstdio>
 #include <cstdlib>
 #include <memory>
 #if defined(UNIX) || defined(TARGET_COMPILER_MINGW)
 #include <unistd.h>
 #endif
+#ifdef UNIX
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
 
 #include "branch.h"
 #include "chardump.h"
@@ -53,6 +58,8 @@
 #include "state.h"
 #include "status.h"
 #include "stringutil.h"
+#include "syscalls.h"
+#include "tags.h"
 #ifdef USE_TILE
  #include "tilepick.h"
 #endif
@@ -69,8 +76,6 @@ using namespace ui;
 
 // enough memory allocated to snarf in the scorefile entries
 static unique_ptr<scorefile_entry> hs_list[SCORE_FILE_ENTRIES];
-static int hs_list_size = 0;
-static bool hs_list_initialized = false;
 
 static FILE *_hs_open(const char *mode, const string &filename);
 static void  _hs_close(FILE *handle);
@@ -103,114 +108,328 @@ static string _log_file_name(bool milestones=false)
         + crawl_state.game_type_qualifier());
 }
 
-int hiscores_new_entry(const scorefile_entry &ne)
+// Lines up to this long are appended to the logfile and milestones file
+// with a single O_APPEND write, which other processes' appends can't
+// interleave with, so every game on a server doesn't queue for the lock.
+#define XLOG_ATOMIC_LINE 4096
+
+/**
+ * Append a complete line (with its newline) to an xlog file.
+ *
+ * @return Whether the whole line was written.
+ */
+static bool _xlog_append(const string &filename, const string &line)
 {
-    unwind_bool score_update(crawl_state.updating_scores, true);
+#ifdef UNIX
+    if (line.size() <= XLOG_ATOMIC_LINE)
+    {
+        const int fd = open_u(filename.c_str(),
+                              O_WRONLY | O_APPEND | O_CREAT, 0666);
+        if (fd < 0)
+            return false;
+        ssize_t written;
+        do
+            written = write(fd, line.data(), line.size());
+        while (written < 0 && errno == EINTR);
+        return !close(fd) && written == (ssize_t) line.size();
+    }
+#endif
 
-    FILE *scores;
-    int i;
-    bool inserted = false;
-    int newest_entry = -1;
+    FILE *fp = lk_open("a", filename);
+    if (!fp)
+        return false;
+    const bool ok = fputs(line.c_str(), fp) >= 0 && !fflush(fp);
+    lk_close(fp);
+    return ok;
+}
 
-    // open highscore file (reading) -- nullptr is fatal!
-    //
-    // Opening as a+ instead of r+ to force an exclusive lock (see
-    // hs_open) and to create the file if it's not there already.
-    scores = _hs_open("a+", _score_file_name());
-    if (scores == nullptr)
-        end(1, true, "failed to open score file for writing");
+/*
+ * The score file is append-only: a new high score is written to its end and
+ * the existing lines are left alone. Ranking lives in a small index file
+ * beside it, which lists the offsets of the top SCORE_FILE_ENTRIES entries
+ * in rank order and is replaced atomically with a rename. An index that
+ * doesn't describe the current score file -- one written by an older
+ * version, or left behind by a crash between the append and the index
+ * update -- is rebuilt by scanning the score file, so old score files need
+ * no explicit conversion.
+ *
+ * Entries that fall off the bottom of the table stay in the score file
+ * until it holds twice as many lines as the table, when a new file with
+ * just the ranked entries is renamed over it.
+ */
 
-    // we're at the end of the file, seek back to beginning.
-    fseek(scores, 0, SEEK_SET);
+#define SCORE_INDEX_MAGIC   0x58444953 // "SIDX"
+#define SCORE_INDEX_VERSION 1
 
-    // read highscore file, inserting new entry at appropriate point,
-    for (i = 0; i < SCORE_FILE_ENTRIES; i++)
+struct score_index_entry
+{
+    int score;
+    int offset;
+};
+
+struct score_index
+{
+    score_index() : log_size(0), log_lines(0) { }
+
+    int log_size;   // Size of the score file this index describes.
+    int log_lines;  // Entries in the score file, ranked or not.
+    vector<score_index_entry> ranks;
+};
+
+static string _score_index_name()
+{
+    return _score_file_name() + ".idx";
+}
+
+static bool _read_score_index_header(reader &inf, FILE *scores,
+                                     score_index &index, int &count)
+{
+    if (unmarshallInt(inf) != SCORE_INDEX_MAGIC
+        || unmarshallInt(inf) != SCORE_INDEX_VERSION)
     {
-        hs_list[i].reset(new scorefile_entry);
-        if (_hs_read(scores, *hs_list[i]) == false)
-            break;
+        return false;
+    }
+    index.log_size = unmarshallInt(inf);
+    index.log_lines = unmarshallInt(inf);
+    count = unmarshallInt(inf);
+    return index.log_size == file_size(scores)
+           && count >= 0 && count <= SCORE_FILE_ENTRIES;
+}
 
-        // compare points..
-        if (!inserted && ne.get_score() >= hs_list[i]->get_score())
+// Load the index, if it is up to date. Returns false if it isn't.
+static bool _load_score_index(FILE *scores, score_index &index)
+{
+    FILE *indexf = fopen_u(_score_index_name().c_str(), "rb");
+    if (!indexf)
+        return false;
+
+    bool ok = false;
+    try
+    {
+        reader inf(indexf);
+        inf.set_safe_read(true);
+        int count;
+        if (_read_score_index_header(inf, scores, index, count))
         {
-            newest_entry = i;           // for later printing
-            inserted = true;
-            // copy read entry to i+1th position
-            // Fixed a nasty overflow bug here -- Sharp
-            if (i+1 < SCORE_FILE_ENTRIES)
+            index.ranks.resize(count);
+            for (score_index_entry &entry : index.ranks)
             {
-                hs_list[i + 1] = std::move(hs_list[i]);
-                hs_list[i].reset(new scorefile_entry(ne));
-                i++;
+                entry.score = unmarshallInt(inf);
+                entry.offset = unmarshallInt(inf);
             }
-            else
-                *hs_list[i] = ne; // copy new entry to current position
+            ok = true;
         }
     }
+    catch (short_read_exception &E)
+    {
+    }
+    fclose(indexf);
+    return ok;
+}
 
-    // special case: lowest score, with room
-    if (!inserted && i < SCORE_FILE_ENTRIES)
+// Rebuild the index by reading every entry in the score file. Entries
+// with equal scores keep their order in the file; lines that can't be read
+// are left out.
+static void _rebuild_score_index(FILE *scores, score_index &index)
+{
+    index = score_index();
+    fseek(scores, 0, SEEK_SET);
+    for (;;)
     {
-        newest_entry = i;
-        inserted = true;
-        // copy new entry
-        hs_list[i].reset(new scorefile_entry(ne));
-        i++;
+        const long offset = ftell(scores);
+        scorefile_entry se;
+        const bool ok = _hs_read(scores, se);
+        if (ftell(scores) == offset)
+            break;
+        if (!ok)
+            continue;
+        // A line cut short by a crash.
+        const string line = se.raw_string();
+        if (feof(scores) && (line.empty() || line.back() != '\n'))
+            break;
+        index.ranks.push_back({se.get_score(), (int) offset});
+        index.log_lines++;
     }
+    stable_sort(index.ranks.begin(), index.ranks.end(),
+                [](const score_index_entry &a, const score_index_entry &b)
+                {
+                    return a.score > b.score;
+                });
+    if (index.ranks.size() > SCORE_FILE_ENTRIES)
+        index.ranks.resize(SCORE_FILE_ENTRIES);
+    index.log_size = file_size(scores);
+}
 
-    hs_list_size = i;
-    hs_list_initialized = true;
+static void _get_score_index(FILE *scores, score_index &index)
+{
+    if (!_load_score_index(scores, index))
+    {
+        dprf("Rebuilding score index %s", _score_index_name().c_str());
+        _rebuild_score_index(scores, index);
+    }
+}
 
-    // If we've still not inserted it, it's not a highscore.
-    if (!inserted)
+static bool _save_score_index(const score_index &index)
+{
+    const string filename = _score_index_name();
+    const string tmpname = filename + ".tmp";
+    FILE *indexf = fopen_replace(tmpname.c_str());
+    if (!indexf)
+        return false;
+
+    writer outf(tmpname, indexf, true);
+    marshallInt(outf, SCORE_INDEX_MAGIC);
+    marshallInt(outf, SCORE_INDEX_VERSION);
+    marshallInt(outf, index.log_size);
+    marshallInt(outf, index.log_lines);
+    marshallInt(outf, index.ranks.size());
+    for (const score_index_entry &entry : index.ranks)
     {
-        _hs_close(scores);
-        return -1;
+        marshallInt(outf, entry.score);
+        marshallInt(outf, entry.offset);
     }
 
-    // The old code closed and reopened the score file, leading to a
-    // race condition where one Crawl process could overwrite the
-    // other's highscore. Now we truncate and rewrite the file without
-    // closing it.
-    if (ftruncate(fileno(scores), 0))
-        end(1, true, "unable to truncate scorefile");
+    const bool ok = outf.succeeded() && !fclose(indexf);
+    if (!ok || rename_u(tmpname.c_str(), filename.c_str()))
+    {
+        unlink_u(tmpname.c_str());
+        return false;
+    }
+    return true;
+}
 
-    rewind(scores);
+static bool _read_score_at(FILE *scores, int offset, scorefile_entry &se)
+{
+    return !fseek(scores, offset, SEEK_SET) && _hs_read(scores, se);
+}
 
-    // write scorefile entries.
-    for (i = 0; i < hs_list_size; i++)
+// Read the entries ranked start to start + count - 1 into hs_list, without
+// touching the rest of the score file. Returns the number read.
+static int _read_score_window(FILE *scores, const score_index &index,
+                              int start, int count)
+{
+    int read = 0;
+    for (int rank = start; rank < start + count
+                           && rank < (int) index.ranks.size(); ++rank)
     {
-        _hs_write(scores, *hs_list[i]);
+        hs_list[read].reset(new scorefile_entry);
+        if (!_read_score_at(scores, index.ranks[rank].offset, *hs_list[read]))
+            break;
+        ++read;
+    }
+    return read;
+}
 
-        // Leave in memory. Does this anyway if !inserted.
-        // Can write cleanup function if nessicary??
-        // hs_list[i].reset(nullptr);
+// Replace the score file with one holding just the ranked entries, dropping
+// everything that has fallen off the bottom of the table. On any failure the
+// old file and index are left as they were.
+static void _compact_score_file(FILE *scores, score_index &index)
+{
+    vector<scorefile_entry> kept(index.ranks.size());
+    for (unsigned int i = 0; i < kept.size(); ++i)
+        if (!_read_score_at(scores, index.ranks[i].offset, kept[i]))
+            return;
+
+    const string filename = _score_file_name();
+    const string tmpname = filename + ".tmp";
+    FILE *out = fopen_replace(tmpname.c_str());
+    if (!out)
+        return;
+
+    vector<int> offsets;
+    int offset = 0;
+    for (scorefile_entry &se : kept)
+    {
+        offsets.push_back(offset);
+        _hs_write(out, se);
+        offset += se.raw_string().size();
+    }
+    bool ok = !fflush(out) && file_size(out) == offset;
+    ok = !fclose(out) && ok;
+    if (!ok || rename_u(tmpname.c_str(), filename.c_str()))
+    {
+        unlink_u(tmpname.c_str());
+        return;
     }
 
-    // close scorefile.
-    _hs_close(scores);
-    return newest_entry;
+    for (unsigned int i = 0; i < offsets.size(); ++i)
+        index.ranks[i].offset = offsets[i];
+    index.log_size = offset;
+    index.log_lines = kept.size();
 }
 
-void logfile_new_entry(const scorefile_entry &ne)
+int hiscores_new_entry(const scorefile_entry &ne)
 {
-    unwind_bool logfile_update(crawl_state.updating_scores, true);
+    unwind_bool score_update(crawl_state.updating_scores, true);
 
-    FILE *logfile;
-    scorefile_entry le = ne;
+    // open highscore file -- nullptr is fatal!
+    //
+    // Opening as a+ to force an exclusive lock (see hs_open) and to create
+    // the file if it's not there already. Writes always go to the end.
+    FILE *scores = _hs_open("a+", _score_file_name());
+    if (scores == nullptr)
+        end(1, true, "failed to open score file for writing");
 
-    // open logfile (appending) -- nullptr *is* fatal here.
-    logfile = _hs_open("a", _log_file_name());
-    if (logfile == nullptr)
+    score_index index;
+    _get_score_index(scores, index);
+
+    // Ties rank in file order, here as in _rebuild_score_index(), so the
+    // new entry, which goes at the end of the file, goes below any
+    // existing entries with the same score. (Before the index, it went
+    // above them.)
+    auto pos = upper_bound(index.ranks.begin(), index.ranks.end(),
+                           ne.get_score(),
+                           [](int score, const score_index_entry &entry)
+                           {
+                               return score > entry.score;
+                           });
+    const int newest_entry = pos - index.ranks.begin();
+
+    // If it doesn't make the table, it's not a highscore.
+    if (newest_entry >= SCORE_FILE_ENTRIES)
     {
-        mprf(MSGCH_ERROR, "ERROR: failure writing to the logfile.");
-        return;
+        _hs_close(scores);
+        return -1;
+    }
+
+    // Don't run on from a line cut short by a crash.
+    const int offset = file_size(scores);
+    if (offset > 0 && !fseek(scores, offset - 1, SEEK_SET)
+        && fgetc(scores) != '\n')
+    {
+        fputc('\n', scores);
     }
 
-    _hs_write(logfile, le);
+    scorefile_entry se = ne;
+    fseek(scores, 0, SEEK_END);
+    const int entry_offset = file_size(scores);
+    _hs_write(scores, se);
+    if (fflush(scores))
+        end(1, true, "unable to write scorefile");
 
-    // close logfile.
-    _hs_close(logfile);
+    index.ranks.insert(pos, {ne.get_score(), entry_offset});
+    if (index.ranks.size() > SCORE_FILE_ENTRIES)
+        index.ranks.resize(SCORE_FILE_ENTRIES);
+    index.log_size = file_size(scores);
+    index.log_lines++;
+
+    if (index.log_lines > 2 * SCORE_FILE_ENTRIES)
+        _compact_score_file(scores, index);
+
+    // If this fails, the next reader will rebuild the index.
+    if (!_save_score_index(index))
+        mprf(MSGCH_ERROR, "ERROR: failure writing the score index.");
+
+    _hs_close(scores);
+    return newest_entry;
+}
+
+void logfile_new_entry(const scorefile_entry &ne)
+{
+    unwind_bool logfile_update(crawl_state.updating_scores, true);
+
+    if (!_xlog_append(_log_file_name(), ne.raw_string()))
+        mprf(MSGCH_ERROR, "ERROR: failure writing to the logfile.");
 }
 
 template <class t_printf>
@@ -234,38 +453,13 @@ static void _hiscores_print_entry(const scorefile_entry &se,
     pf("%s", entry.c_str());
 }
 
-// Reads hiscores file to memory
-void hiscores_read_to_memory()
-{
-    FILE *scores;
-    int i;
-
-    // open highscore file (reading)
-    scores = _hs_open("r", _score_file_name());
-    if (scores == nullptr)
-        return;
-
-    // read highscore file
-    for (i = 0; i < SCORE_FILE_ENTRIES; i++)
-    {
-        hs_list[i].reset(new scorefile_entry);
-        if (_hs_read(scores, *hs_list[i]) == false)
-            break;
-    }
-
-    hs_list_size = i;
-    hs_list_initialized = true;
-
-    //close off
-    _hs_close(scores);
-}
-
 // Writes all entries in the scorefile to stdout in human-readable form.
 void hiscores_print_all(int display_count, int format)
 {
     unwind_bool scorefile_display(crawl_state.updating_scores, true);
 
-    FILE *scores = _hs_open("r", _score_file_name());
+    const string filename = _score_file_name();
+    FILE *scores = _hs_open("r", filename);
     if (scores == nullptr)
     {
         // will only happen from command line
@@ -273,11 +467,20 @@ void hiscores_print_all(int display_count, int format)
         return;
     }
 
+    // Standard input can't be indexed; print it in file order.
+    score_index index;
+    if (filename != "-")
+        _get_score_index(scores, index);
+
     for (int entry = 0; display_count <= 0 || entry < display_count; ++entry)
     {
         scorefile_entry se;
-        if (!_hs_read(scores, se))
+        if (filename == "-" ? !_hs_read(scores, se)
+            : entry >= (int) index.ranks.size()
+              || !_read_score_at(scores, index.ranks[entry].offset, se))
+        {
             break;
+        }
 
         if (format == -1)
             printf("%s", se.raw_string().c_str());
@@ -295,16 +498,16 @@ string hiscores_print_list(int display_count, int format, int newest_entry, int&
     unwind_bool scorefile_display(crawl_state.updating_scores, true);
     string ret;
 
-    // Additional check to preserve previous functionality
-    if (!hs_list_initialized)
-        hiscores_read_to_memory();
-
-    int i, total_entries;
-
     if (display_count <= 0)
         return "";
 
-    total_entries = hs_list_size;
+    FILE *scores = _hs_open("r", _score_file_name());
+    if (scores == nullptr)
+        return "";
+
+    score_index index;
+    _get_score_index(scores, index);
+    const int total_entries = index.ranks.size();
 
     int start = newest_entry - display_count / 2;
 
@@ -314,20 +517,24 @@ string hiscores_print_list(int display_count, int format, int newest_entry, int&
     if (start < 0)
         start = 0;
 
-    const int finish = start + display_count;
+    // Only read the entries being displayed.
+    const int count = _read_score_window(scores, index, start, display_count);
+    _hs_close(scores);
 
-    for (i = start; i < finish && i < total_entries; i++)
+    for (int i = 0; i < count; i++)
     {
+        const int rank = start + i;
+
         // check for recently added entry
-        if (i == newest_entry)
+        if (rank == newest_entry)
             ret += "<yellow>";
 
-        _hiscores_print_entry(*hs_list[i], i, format, [&ret](const char */*fmt*/, const char *s){
+        _hiscores_print_entry(*hs_list[i], rank, format, [&ret](const char */*fmt*/, const char *s){
             ret += string(s);
         });
 
         // return to normal color for next entry
-        if (i == newest_entry)
+        if (rank == newest_entry)
             ret += "<lightgrey>";
     }
 
@@ -466,14 +673,10 @@ void UIHiscoresMenu::_construct_hiscore_table()
     if (scores == nullptr)
         return;
 
-    int i;
     // read highscore file
-    for (i = 0; i < SCORE_FILE_ENTRIES; i++)
-    {
-        hs_list[i].reset(new scorefile_entry);
-        if (_hs_read(scores, *hs_list[i]) == false)
-            break;
-    }
+    score_index index;
+    _get_score_index(scores, index);
+    const int i = _read_score_window(scores, index, 0, SCORE_FILE_ENTRIES);
 
     _hs_close(scores);
 
@@ -602,7 +805,26 @@ static FILE *_hs_open(const char *mode, const string &scores)
     if (scores == "-")
         return stdin;
 
+#ifdef UNIX
+    // Compaction renames a new score file into place. If that happened
+    // while we waited for the lock, what we have locked is the old file,
+    // so open the new one instead.
+    while (true)
+    {
+        FILE *handle = lk_open(mode, scores);
+        struct stat locked, current;
+        if (!handle || fstat(fileno(handle), &locked)
+            || stat(scores.c_str(), &current)
+            || locked.st_dev == current.st_dev
+               && locked.st_ino == current.st_ino)
+        {
+            return handle;
+        }
+        lk_close(handle);
+    }
+#else
     return lk_open(mode, scores);
+#endif
 }
 
 static void _hs_close(FILE *handle)
@@ -3030,21 +3252,33 @@ void xlog_fields::map_fields() const
 string xlog_fields::xlog_line() const
 {
     string line;
+    append_line(line);
+    return line;
+}
+
+// Append the xlog line to out, escaping as we go rather than through
+// temporary strings.
+void xlog_fields::append_line(string &out) const
+{
+    const string::size_type start = out.size();
     for (const pair<string, string> &f : fields)
     {
         // Don't write empty fields.
         if (f.second.empty())
             continue;
 
-        if (!line.empty())
-            line += ":";
+        if (out.size() > start)
+            out += ':';
 
-        line += f.first;
-        line += "=";
-        line += _xlog_escape(f.second);
+        out += f.first;
+        out += '=';
+        for (char c : f.second)
+        {
+            out += c;
+            if (c == ':')
+                out += ':';
+        }
     }
-
-    return line;
 }
 
 #ifdef USE_TILE_WEB
@@ -3150,14 +3384,13 @@ void mark_milestone(const string &type, const string &milestone,
         return;
 #endif
 
-    const string xlog_line = xl.xlog_line();
-    const string milestone_file = _log_file_name(true);
-
-    if (FILE *fp = lk_open("a", milestone_file))
-    {
-        fprintf(fp, "%s\n", xlog_line.c_str());
-        lk_close(fp);
-    }
+    // Kept between milestones, so that its buffer is only allocated once.
+    static string xlog_line;
+    xlog_line.clear();
+    xlog_line.reserve(XLOG_ATOMIC_LINE);
+    xl.append_line(xlog_line);
+    xlog_line += '\n';
+    _xlog_append(_log_file_name(true), xlog_line);
 #endif
 #else
     UNUSED(type, milestone, origin_level, milestone_time);
@@ -21,8 +21,6 @@ int hiscores_new_entry(const scorefile_entry &se);
 
 void logfile_new_entry(const scorefile_entry &se);
 
-void hiscores_read_to_memory();
-
 string hiscores_print_list(int display_count, int format, int newest_entry, int& start_out);
 void hiscores_print_all(int display_count = -1, int format = SCORE_TERSE);
 void show_hiscore_table();
@@ -49,6 +47,7 @@ public:
 
     void init(const string &line);
     string xlog_line() const;
+    void append_line(string &out) const;
 #ifdef USE_TILE_WEB
     JsonWrapper xlog_json() const;
 #endif
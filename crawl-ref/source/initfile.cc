@@ -4580,6 +4580,7 @@ enum commandline_option_type
     CLO_OBJSTAT,
     CLO_ITERATIONS,
     CLO_FORCE_MAP,
+    CLO_JOBS,
     CLO_ARENA,
     CLO_DUMP_MAPS,
     CLO_TEST,
@@ -4621,6 +4622,12 @@ enum commandline_option_type
     CLO_PRINT_WEBTILES_OPTIONS,
 #endif
     CLO_RESET_CACHE,
+    CLO_PREBUILD_DB,
+    CLO_STARTUP_PROFILE,
+    CLO_TURN_LOG,
+    CLO_ZYGOTE,
+    CLO_SEED_SCAN,
+    CLO_DEPTH,
 
     CLO_NOPS
 };
@@ -4631,6 +4638,12 @@ static set<commandline_option_type> clo_headless_ok = {
     CLO_SCORES,
     CLO_BUILDDB,
     CLO_RESET_CACHE,
+    CLO_PREBUILD_DB,
+    CLO_STARTUP_PROFILE,
+    CLO_TURN_LOG,
+    CLO_SEED_SCAN,
+    CLO_DEPTH,
+    CLO_JOBS,
     CLO_HELP,
     CLO_VERSION,
     CLO_PLAYABLE_JSON, // JSON metadata for species, jobs, combos.
@@ -4659,7 +4672,8 @@ static const char *cmd_ops[] =
 {
     "scores", "name", "species", "background", "dir", "rc", "rcdir", "tscores",
     "vscores", "scorefile", "morgue", "macro", "mapstat", "dump-disconnect",
-    "objstat", "iters", "force-map", "arena", "dump-maps", "test", "script",
+    "objstat", "iters", "force-map", "jobs", "arena", "dump-maps", "test",
+    "script",
     "builddb", "help", "version", "seed", "pregen", "save-version", "sprint",
     "extra-opt-first", "extra-opt-last", "sprint-map", "edit-save",
     "print-charset", "tutorial", "wizard", "explore", "no-save",
@@ -4672,7 +4686,8 @@ static const char *cmd_ops[] =
 #ifdef USE_TILE_WEB
     "webtiles-socket", "await-connection", "print-webtiles-options",
 #endif
-    "reset-cache",
+    "reset-cache", "prebuild-db", "startup-profile", "turn-log",
+    "zygote", "seed-scan", "depth",
 };
 
 
@@ -5491,6 +5506,7 @@ bool parse_args(int argc, char **argv, bool rc_only)
 
     SysEnv.rcdirs.clear();
     SysEnv.map_gen_iters = 0;
+    SysEnv.map_gen_jobs = 1;
 
     if (argc < 2)           // no args!
         return true;
@@ -5685,6 +5701,16 @@ bool parse_args(int argc, char **argv, bool rc_only)
 #endif
             break;
 
+        case CLO_JOBS:
+            if (!next_is_param || !isadigit(*next_arg))
+                end(1, false, "Integer argument required for -%s\n", arg);
+            else
+            {
+                SysEnv.map_gen_jobs = max(1, min(atoi(next_arg), 64));
+                nextUsed = true;
+            }
+            break;
+
         case CLO_ARENA:
             if (!rc_only)
             {
@@ -5774,6 +5800,60 @@ bool parse_args(int argc, char **argv, bool rc_only)
             crawl_state.use_des_cache = false;
             break;
 
+        case CLO_PREBUILD_DB:
+            if (!next_is_param)
+                return false;
+            crawl_state.prebuild_db_dir = next_arg;
+            nextUsed = true;
+            enter_headless_mode();
+            break;
+
+        case CLO_STARTUP_PROFILE:
+            if (next_is_param)
+                return false;
+            crawl_state.startup_profile = true;
+            enter_headless_mode();
+            break;
+
+        case CLO_TURN_LOG:
+            if (!next_is_param)
+                return false;
+            crawl_state.turn_log_file = next_arg;
+            nextUsed = true;
+            break;
+
+        case CLO_ZYGOTE:
+#ifdef UNIX
+            if (!next_is_param)
+                return false;
+            crawl_state.zygote_socket = next_arg;
+            nextUsed = true;
+            break;
+#else
+            end(1, false, "-zygote is only supported on Unix.");
+#endif
+
+        case CLO_SEED_SCAN:
+            if (!next_is_param || current + 2 >= argc
+                || !sscanf(next_arg, "%" SCNu64, &crawl_state.seed_scan_first)
+                || !sscanf(argv[current + 2], "%" SCNu64,
+                           &crawl_state.seed_scan_last))
+            {
+                end(1, false, "-seed-scan needs two seeds: <from> <to>\n");
+            }
+            crawl_state.seed_scan = true;
+            enter_headless_mode();
+            current++;
+            nextUsed = true;
+            break;
+
+        case CLO_DEPTH:
+            if (!next_is_param)
+                return false;
+            crawl_state.seed_scan_depth = next_arg;
+            nextUsed = true;
+            break;
+
         case CLO_GDB:
             crawl_state.no_gdb = 0;
             break;
@@ -114,10 +114,7 @@ public:
 
     int  armour_rating() const;
 
-    void clear()
-    {
-        *this = item_def();
-    }
+    void clear();
 
     /**
      * Sets this item as being held by a given monster.
@@ -2100,6 +2100,23 @@ void check_if_everything_is_identified()
     you.props[IDENTIFIED_ALL_KEY] = true;
 }
 
+static unsigned int _item_name_generation = 0;
+
+/**
+ * A number that changes whenever item names might have, for callers that
+ * keep names around between uses (e.g. the stash tracker).
+ */
+unsigned int item_name_generation()
+{
+    return _item_name_generation;
+}
+
+// Call when item knowledge changes, or anything else that names depend on.
+void invalidate_item_names()
+{
+    ++_item_name_generation;
+}
+
 bool set_ident_type(item_def &item, bool identify, bool check_last)
 {
     if (is_artefact(item) || crawl_state.game_is_arena())
@@ -2141,6 +2158,7 @@ bool set_ident_type(object_class_type basetype, int subtype, bool identify,
         return false;
 
     you.type_ids[basetype][subtype] = identify;
+    invalidate_item_names();
     maybe_mark_set_known(basetype, subtype);
     request_autoinscribe();
 
@@ -149,6 +149,9 @@ bool set_ident_type(item_def &item, bool identify, bool check_last=true);
 bool set_ident_type(object_class_type basetype, int subtype, bool identify,
                     bool check_last=true);
 
+unsigned int item_name_generation();
+void invalidate_item_names();
+
 string item_prefix(const item_def &item, bool temp = true);
 string menu_colour_item_name(const item_def &item,
                                    description_level_type desc);
@@ -1343,6 +1343,7 @@ bool set_item_ego_type(item_def &item, object_class_type item_type,
     if (item.base_type == item_type && !is_artefact(item))
     {
         item.brand = ego_type;
+        you.equipment_changed();
         return true;
     }
 
@@ -102,6 +102,84 @@ static inline string _autopickup_item_name(const item_def &item)
            + item_prefix(item, false) + " " + item.name(DESC_PLAIN);
 }
 
+// No env.item slot below this one is free. Freeing a slot (through
+// item_def::clear()) lowers it, and link_items() resets it whenever env.item
+// has been rebuilt, so get_mitm_slot() can start looking here instead of at
+// the start of the array, which matters on levels full of items.
+static int _first_free_item = 0;
+
+static void _item_slot_freed(int slot)
+{
+    _first_free_item = min(_first_free_item, slot);
+}
+
+// An index of the stacks in env.igrid: how many items each cell holds, and
+// the cells that hold any, in no particular order. It isn't saved;
+// link_items() rebuilds it, and everything below that links an item into
+// a stack or unlinks one keeps it up to date.
+static FixedArray<short, GXM, GYM> _floor_count;
+static FixedArray<int, GXM, GYM> _floor_cell_index; // where in _floor_cells
+static vector<coord_def> _floor_cells;
+
+static void _floor_stack_changed(const coord_def &pos, int delta)
+{
+    short &count = _floor_count(pos);
+    const bool was_empty = !count;
+    count += delta;
+    ASSERT(count >= 0);
+    if (was_empty && count)
+    {
+        _floor_cell_index(pos) = _floor_cells.size();
+        _floor_cells.push_back(pos);
+    }
+    else if (!was_empty && !count)
+    {
+        const int i = _floor_cell_index(pos);
+        _floor_cells[i] = _floor_cells.back();
+        _floor_cell_index(_floor_cells[i]) = i;
+        _floor_cells.pop_back();
+    }
+}
+
+static void _rebuild_floor_index()
+{
+    _floor_count.init(0);
+    _floor_cells.clear();
+    for (int x = 0; x < GXM; x++)
+        for (int y = 0; y < GYM; y++)
+        {
+            int n = 0;
+            for (int i = env.igrid[x][y]; i != NON_ITEM; i = env.item[i].link)
+                ++n;
+            if (n)
+                _floor_stack_changed(coord_def(x, y), n);
+        }
+}
+
+/// Empty every stack in env.igrid, without touching env.item.
+void clear_item_grid()
+{
+    env.igrid.init(NON_ITEM);
+    _floor_count.init(0);
+    _floor_cells.clear();
+}
+
+/// How many items are linked into the stack at pos.
+int floor_item_count(const coord_def &pos)
+{
+    return _floor_count(pos);
+}
+
+/**
+ * The cells that have a stack in env.igrid, in no particular order. Moving
+ * or destroying items changes it, so copy it first to do that while going
+ * through it.
+ */
+const vector<coord_def> &floor_item_cells()
+{
+    return _floor_cells;
+}
+
 // Used to be called "unlink_items", but all it really does is make
 // sure item coordinates are correct to the stack they're in. -- bwr
 void fix_item_coordinates()
@@ -125,7 +203,8 @@ void fix_item_coordinates()
 void link_items()
 {
     // First, initialise env.igrid array.
-    env.igrid.init(NON_ITEM);
+    clear_item_grid();
+    _first_free_item = 0;
 
     // Link all items on the grid, plus shop inventory,
     // but DON'T link the huge pile of monster items at (-2,-2).
@@ -169,6 +248,7 @@ void link_items()
             env.item[i].link = env.item[movable_ind].link;
             env.item[movable_ind].link = i;
         }
+        _floor_stack_changed(env.item[i].pos, 1);
     }
 }
 
@@ -392,6 +472,7 @@ bool dec_inv_item_quantity(int obj, int amount)
                     canned_msg(MSG_EMPTY_HANDED_NOW);
                 }
                 you.equip[i] = -1;
+                you.equipment_changed();
             }
         }
 
@@ -476,10 +557,25 @@ int get_mitm_slot(int reserve)
 
     int item = NON_ITEM;
 
-    for (item = 0; item < (MAX_ITEMS - reserve); item++)
+    for (item = _first_free_item; item < (MAX_ITEMS - reserve); item++)
         if (!env.item[item].defined())
             break;
 
+    // A slot emptied without clear() wouldn't have lowered the hint, so
+    // look at the rest before culling anything.
+    if (item >= MAX_ITEMS - reserve)
+    {
+        const int checked = min(_first_free_item, MAX_ITEMS - reserve);
+        for (item = 0; item < checked; item++)
+            if (!env.item[item].defined())
+                break;
+        if (item == checked)
+            item = MAX_ITEMS;
+    }
+
+    if (item < MAX_ITEMS - reserve)
+        _first_free_item = item;
+
     if (item >= MAX_ITEMS - reserve)
     {
         if (crawl_state.game_is_arena())
@@ -558,6 +654,7 @@ void unlink_item(int dest)
         {
             // link env.igrid to the second item
             env.igrid(env.item[dest].pos) = env.item[dest].link;
+            _floor_stack_changed(env.item[dest].pos, -1);
 
             env.item[dest].pos.reset();
             env.item[dest].link = NON_ITEM;
@@ -572,6 +669,7 @@ void unlink_item(int dest)
             {
                 // unlink dest
                 si->link = env.item[dest].link;
+                _floor_stack_changed(env.item[dest].pos, -1);
                 env.item[dest].pos.reset();
                 env.item[dest].link = NON_ITEM;
                 return;
@@ -593,6 +691,7 @@ void unlink_item(int dest)
     int  old_link = env.item[dest].link; // used to try linking the first
 
     // Clean the relevant parts of the object.
+    _item_slot_freed(dest);
     env.item[dest].base_type = OBJ_UNASSIGNED;
     env.item[dest].quantity  = 0;
     env.item[dest].link      = NON_ITEM;
@@ -634,6 +733,7 @@ void unlink_item(int dest)
     // Okay, finally warn player if we didn't do anything.
     if (!linked)
         mprf(MSGCH_ERROR, "BUG WARNING: Item didn't seem to be linked at all.");
+    _rebuild_floor_index();
 #endif
 }
 
@@ -698,6 +798,7 @@ void lose_item_stack(const coord_def& where)
         }
     }
     env.igrid(where) = NON_ITEM;
+    _floor_stack_changed(where, -_floor_count(where));
 }
 
 /**
@@ -2372,6 +2473,7 @@ bool move_item_to_grid(int *const obj, const coord_def& p, bool silent)
         item.link = env.igrid(p);
         env.igrid(p) = ob;
     }
+    _floor_stack_changed(p, 1);
 
     if (item_is_orb(item))
         env.orb_pos = p;
@@ -2411,6 +2513,9 @@ void move_item_stack_to_grid(const coord_def& from, const coord_def& to)
 
     env.igrid(to) = env.igrid(from);
     env.igrid(from) = NON_ITEM;
+    const int moved = _floor_count(from);
+    _floor_stack_changed(from, -moved);
+    _floor_stack_changed(to, moved);
 }
 
 // Returns the mitm index of the item. If the item was copied but destroyed,
@@ -3440,6 +3545,13 @@ int item_def::index() const
     return this - env.item.buffer();
 }
 
+void item_def::clear()
+{
+    *this = item_def();
+    if (this >= env.item.buffer() && this < env.item.buffer() + MAX_ITEMS)
+        _item_slot_freed(index());
+}
+
 bool valid_item_index(int i)
 {
     return i >= 0 && i < MAX_ITEMS;
@@ -4632,6 +4744,9 @@ void move_items(const coord_def r, const coord_def p)
     // Move entire stack over to p.
     env.igrid(p) = env.igrid(r);
     env.igrid(r) = NON_ITEM;
+    const int moved = _floor_count(r);
+    _floor_stack_changed(r, -moved);
+    _floor_stack_changed(p, moved);
 }
 
 // erase everything the player doesn't know
@@ -77,6 +77,9 @@ void init_item(int item);
 void add_held_books_to_library();
 
 void link_items();
+void clear_item_grid();
+int floor_item_count(const coord_def &pos);
+const vector<coord_def> &floor_item_cells();
 
 void fix_item_coordinates();
 
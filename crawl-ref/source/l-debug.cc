@@ -8,6 +8,7 @@
 #include "act-iter.h"
 #include "branch.h"
 #include "chardump.h"
+#include "cloud.h"
 #include "cluautil.h"
 #include "coordit.h"
 #include "dbg-util.h"
@@ -360,6 +361,7 @@ LUAFN(debug_viewwindow)
 }
 
 LUAWRAP(debug_seen_monsters_react, seen_monsters_react())
+LUAWRAP(debug_manage_clouds, manage_clouds())
 
 static const char* disablements[] =
 {
@@ -474,6 +476,20 @@ LUAFN(debug_check_moncasts)
     return 1;
 }
 
+// Make fire_tracer() run both the lightweight monster tracer and the full
+// bolt::fire() path, asserting that they agree.
+LUAFN(debug_check_tracers)
+{
+    crawl_state.check_tracers = lua_isnone(ls, 1) || lua_toboolean(ls, 1);
+    return 0;
+}
+
+LUAFN(debug_check_equip_cache)
+{
+    crawl_state.check_equip_cache = lua_isnone(ls, 1) || lua_toboolean(ls, 1);
+    return 0;
+}
+
 const struct luaL_reg debug_dlib[] =
 {
 { "goto_place", debug_goto_place },
@@ -501,10 +517,13 @@ const struct luaL_reg debug_dlib[] =
 { "check_uniques", debug_check_uniques },
 { "viewwindow", debug_viewwindow },
 { "seen_monsters_react", debug_seen_monsters_react },
+{ "manage_clouds", debug_manage_clouds },
 { "disable", debug_disable },
 { "cpp_assert", debug_cpp_assert },
 { "reset_rng", debug_reset_rng },
 { "get_rng_state", debug_get_rng_state },
 { "check_moncasts", debug_check_moncasts },
+{ "check_tracers", debug_check_tracers },
+{ "check_equip_cache", debug_check_equip_cache },
 { nullptr, nullptr }
 };
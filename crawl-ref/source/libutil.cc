@@ -217,13 +217,6 @@ int strip_number_tag(string &s, const string &tagprefix)
     return x;
 }
 
-unordered_set<string> parse_tags(const string &tags)
-{
-    vector<string> split_tags = split_string(" ", tags);
-    unordered_set<string> tags_set(split_tags.begin(), split_tags.end());
-    return tags_set;
-}
-
 bool parse_int(const char *s, int &i)
 {
     if (!s || !*s)
@@ -54,6 +54,8 @@
 #include "losglobal.h"
 #include "mon-act.h"
 #include "mpr.h"
+#include "startup-profile.h"
+#include "turn-profile.h"
 
 // These determine what rays are cast in the precomputation,
 // and affect start-up time significantly.
@@ -463,6 +465,7 @@ static void raycast()
     // Creating all rays for first quadrant
     // We have a considerable amount of overkill.
     done_raycast = true;
+    startup_phase phase("los rays");
 
     // register perpendiculars FIRST, to make them top choice
     // when selecting beams
@@ -800,9 +803,17 @@ struct los_param_funcs : public los_param
     }
 };
 
+void precompute_rays()
+{
+    raycast();
+}
+
 void losight(los_grid& sh, const coord_def& center,
              const opacity_func& opc, const circle_def& bounds)
 {
+    TURN_PROFILE_SCOPE(los);
+    TURN_PROFILE_COUNT(los_updates, 1);
+
     const los_param& dat = los_param_funcs(center, opc, bounds);
 
     sh.init(false);
@@ -37,6 +37,7 @@ bool cell_see_cell_nocache(const coord_def& p1, const coord_def& p2);
 typedef SquareArray<bool, LOS_MAX_RANGE> los_grid;
 
 void clear_rays_on_exit();
+void precompute_rays();
 void losight(los_grid& sh, const coord_def& center,
              const opacity_func &opc = opc_default,
              const circle_def &bds = BDS_DEFAULT);
@@ -125,9 +125,11 @@
 #include "spl-util.h"
 #include "stairs.h"
 #include "startup.h"
+#include "startup-profile.h"
 #include "stash.h"
 #include "state.h"
 #include "stringutil.h"
+#include "syscalls.h"
 #include "tags.h"
 #include "target.h"
 #include "terrain.h"
@@ -140,19 +142,18 @@
 #include "transform.h"
 #include "traps.h"
 #include "travel.h"
+#include "turn-profile.h"
 #include "uncancel.h"
 #include "version.h"
 #include "viewchar.h"
 #include "viewgeom.h"
 #include "view.h"
 #include "viewmap.h"
-#ifdef __ANDROID__
-#include "syscalls.h"
-#endif
 #include "wiz-you.h" // FREEZE_TIME_KEY
 #include "wizard.h" // handle_wizard_command() and enter_explore_mode()
 #include "xom.h" // XOM_CLOUD_TRAIL_TYPE_KEY
 #include "zot.h"
+#include "zygote.h"
 
 // ----------------------------------------------------------------------
 // Globals whose construction/destruction order needs to be managed
@@ -282,19 +283,41 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    // Init monsters up front - needed to handle the mon_glyph option right.
-    init_char_table(CSET_ASCII);
-    init_monsters();
+    {
+        startup_phase phase("monsters");
+        // Init monsters up front - needed to handle the mon_glyph option right.
+        init_char_table(CSET_ASCII);
+        init_monsters();
 
-    // Init name cache. Currently unused, but item_glyph will need these
-    // once implemented.
-    init_properties();
-    init_item_name_cache();
+        // Init name cache. Currently unused, but item_glyph will need these
+        // once implemented.
+        init_properties();
+        init_item_name_cache();
+    }
 
     // make sure all the expected data directories exist
     validate_basedirs();
 
+#ifdef UNIX
+    if (!crawl_state.zygote_socket.empty())
+    {
+        // Only returns in a forked child, with the arguments for its game.
+        zygote_serve(crawl_state.zygote_socket, argc, argv);
+        crawl_state.zygote_socket.clear();
+
+        SysEnv = system_environment();
+        get_system_environment();
+        if (!parse_args(argc, argv, true))
+        {
+            _show_commandline_options_help();
+            return 1;
+        }
+        validate_basedirs();
+    }
+#endif
+
     {
+        startup_phase phase("options");
         // Read the init file -- first pass. This pass ignores lua. It'll get
         // reread with lua on starting a game.
 #ifdef USE_TILE_WEB
@@ -329,8 +352,11 @@ int main(int argc, char *argv[])
     }
 
 #ifdef USE_TILE
-    if (!tiles.initialise())
-        return -1;
+    {
+        startup_phase phase("tiles");
+        if (!tiles.initialise())
+            return -1;
+    }
 #endif
 
 #ifdef USE_TILE_LOCAL
@@ -592,6 +618,23 @@ static void _show_commandline_options_help()
     puts("Miscellaneous options:");
     puts("  -builddb         don't start the game; rebuild the .des cache and exit");
     puts("  -reset-cache     force a full rebuild of the .des cache");
+    puts("  -prebuild-db <dir>  write the text databases to <dir> for installing");
+    puts("                   with the data files, and exit");
+    puts("  -startup-profile write the time and memory used by each phase of");
+    puts("                   starting the game to stdout as JSON, and exit");
+    puts("  -turn-log <file> write the wall time of each turn to <file>, in");
+    puts("                   microseconds (for benchmarks)");
+#ifdef UNIX
+    puts("  -zygote <socket> load the game data once, then start a process for");
+    puts("                   each game requested on <socket> (for webtiles)");
+#endif
+    puts("  -seed-scan <from> <to>  build the levels of each seed in the range");
+    puts("                   and write one line of JSON per level to stdout");
+    puts("  -depth <level>   for -seed-scan, stop after this level or branch");
+    puts("                   (default: Tomb:3)");
+#ifdef UNIX
+    puts("  -jobs <num>      for -seed-scan and -mapstat, use <num> processes");
+#endif
     puts("  -dump-maps       write map Lua to stderr when parsing .des files");
 #ifndef TARGET_OS_WINDOWS
     puts("  -gdb/-no-gdb     produce gdb backtrace when a crash happens (default:on)");
@@ -2545,7 +2588,7 @@ static void _update_still_winds()
     end_still_winds();
 }
 
-void world_reacts()
+static void _world_reacts()
 {
     // All markers should be activated at this point.
     ASSERT(!env.markers.need_activate());
@@ -2688,6 +2731,47 @@ void world_reacts()
     you.los_noise_level = 0;
 }
 
+// For -turn-log: write the time since the end of the previous turn, so
+// that benchmarks see everything a turn costs, including input handling.
+static void _log_turn_time()
+{
+    static FILE *turn_log = nullptr;
+    static chrono::steady_clock::time_point last_turn;
+
+    const auto now = chrono::steady_clock::now();
+    if (!turn_log)
+    {
+        turn_log = fopen_u(crawl_state.turn_log_file.c_str(), "w");
+        if (!turn_log)
+        {
+            end(1, true, "Unable to open turn log: %s",
+                crawl_state.turn_log_file.c_str());
+        }
+    }
+    else
+    {
+        fprintf(turn_log, "%" PRId64 "\n", (int64_t)
+                chrono::duration_cast<chrono::microseconds>(now - last_turn)
+                    .count());
+    }
+    last_turn = now;
+}
+
+void world_reacts()
+{
+    // Names can depend on all sorts of player state; a turn is as long as
+    // any cached ones are allowed to last.
+    invalidate_item_names();
+    {
+        TURN_PROFILE_SCOPE(world_reacts);
+        _world_reacts();
+    }
+    TURN_PROFILE_END_TURN();
+
+    if (!crawl_state.turn_log_file.empty())
+        _log_turn_time();
+}
+
 static command_type _get_next_cmd()
 {
 #ifdef DGL_SIMPLE_MESSAGING
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+
 #include "enum.h"
 #include "mon-info.h"
 #include "tag-version.h"
@@ -59,63 +61,36 @@ struct cloud_info
 /*
  * A map_cell stores what the player knows about a cell.
  * These go in env.map_knowledge.
+ *
+ * The monster, item and cloud payloads are shared between copies of a cell
+ * and never modified in place once set: map knowledge is copied wholesale
+ * for redraws and webtiles diffing, and copying a cell should not mean
+ * copying a monster_info. Anything that needs to change a payload replaces
+ * it instead.
  */
 struct map_cell
 {
     map_cell() : flags(0), _feat(DNGN_UNSEEN), _feat_colour(0),
-                 _trap(TRAP_UNASSIGNED), _cloud(0), _item(0), _mons(0)
-    {
-    }
-
-    map_cell(const map_cell& c)
-    {
-        memcpy(this, &c, sizeof(map_cell));
-        if (_cloud)
-            _cloud = new cloud_info(*_cloud);
-        if (_mons)
-            _mons = new monster_info(*_mons);
-        if (_item)
-            _item = new item_def(*_item);
-    }
-
-    ~map_cell()
-    {
-        if (_cloud)
-            delete _cloud;
-        if (!(flags & MAP_DETECTED_MONSTER) && _mons)
-            delete _mons;
-        if (_item)
-            delete _item;
-    }
-
-    map_cell& operator=(const map_cell& c)
+                 _trap(TRAP_UNASSIGNED)
     {
-        if (&c == this)
-            return *this;
-        if (_cloud)
-            delete _cloud;
-        if (_mons)
-            delete _mons;
-        if (_item)
-            delete _item;
-        memcpy(this, &c, sizeof(map_cell));
-        if (_cloud)
-            _cloud = new cloud_info(*_cloud);
-        if (_mons)
-            _mons = new monster_info(*_mons);
-        if (_item)
-            _item = new item_def(*_item);
-        return *this;
     }
 
+    // Payloads are compared by identity: two cells compare equal only if
+    // they share their payloads, as after a copy.
     bool operator ==(const map_cell &other) const
     {
-        return memcmp(this, &other, sizeof(map_cell)) == 0;
+        return flags == other.flags
+               && _feat == other._feat
+               && _feat_colour == other._feat_colour
+               && _trap == other._trap
+               && _cloud == other._cloud
+               && _item == other._item
+               && _mons == other._mons;
     }
 
     bool operator !=(const map_cell &other) const
     {
-        return memcmp(this, &other, sizeof(map_cell)) != 0;
+        return !(*this == other);
     }
 
     void clear()
@@ -153,9 +128,14 @@ struct map_cell
         _trap = tr;
     }
 
-    item_def* item() const
+    const item_def* item() const
+    {
+        return _item.get();
+    }
+
+    item_def* mutable_item()
     {
-        return _item;
+        return _unshare(_item);
     }
 
     bool detected_item() const
@@ -173,7 +153,7 @@ struct map_cell
     void set_item(const item_def& ii, bool more_items)
     {
         clear_item();
-        _item = new item_def(ii);
+        _item = make_shared<item_def>(ii);
         if (more_items)
             flags |= MAP_MORE_ITEMS;
     }
@@ -182,11 +162,7 @@ struct map_cell
 
     void clear_item()
     {
-        if (_item)
-        {
-            delete _item;
-            _item = 0;
-        }
+        _item.reset();
         flags &= ~(MAP_DETECTED_ITEM | MAP_MORE_ITEMS);
     }
 
@@ -198,15 +174,28 @@ struct map_cell
             return MONS_NO_MONSTER;
     }
 
-    monster_info* monsterinfo() const
+    const monster_info* monsterinfo() const
+    {
+        return _mons.get();
+    }
+
+    monster_info* mutable_monsterinfo()
     {
-        return _mons;
+        return _unshare(_mons);
     }
 
     void set_monster(const monster_info& mi)
     {
         clear_monster();
-        _mons = new monster_info(mi);
+        _mons = make_shared<monster_info>(mi);
+    }
+
+    // As set_monster(monster_info(args...)), without the copy.
+    template<typename... Args>
+    void emplace_monster(Args&&... args)
+    {
+        clear_monster();
+        _mons = make_shared<monster_info>(forward<Args>(args)...);
     }
 
     bool detected_monster() const
@@ -222,8 +211,9 @@ struct map_cell
     void set_detected_monster(monster_type mons)
     {
         clear_monster();
-        _mons = new monster_info(MONS_SENSED);
-        _mons->base_type = mons;
+        auto mi = make_shared<monster_info>(MONS_SENSED);
+        mi->base_type = mons;
+        _mons = move(mi);
         flags |= MAP_DETECTED_MONSTER;
     }
 
@@ -235,10 +225,8 @@ struct map_cell
 
     void clear_monster()
     {
-        if (_mons)
-            delete _mons;
+        _mons.reset();
         flags &= ~(MAP_DETECTED_MONSTER | MAP_INVISIBLE_MONSTER);
-        _mons = 0;
     }
 
     cloud_type cloud() const
@@ -257,25 +245,24 @@ struct map_cell
             return 0;
     }
 
-    cloud_info* cloudinfo() const
+    const cloud_info* cloudinfo() const
     {
-        return _cloud;
+        return _cloud.get();
+    }
+
+    cloud_info* mutable_cloudinfo()
+    {
+        return _unshare(_cloud);
     }
 
     void set_cloud(const cloud_info& ci)
     {
-        if (_cloud)
-            delete _cloud;
-        _cloud = new cloud_info(ci);
+        _cloud = make_shared<cloud_info>(ci);
     }
 
     void clear_cloud()
     {
-        if (_cloud)
-        {
-            delete _cloud;
-            _cloud = 0;
-        }
+        _cloud.reset();
     }
 
     bool update_cloud_state();
@@ -313,10 +300,19 @@ struct map_cell
 public:
     uint32_t flags;   // Flags describing the mappedness of this square.
 private:
+    // Give this cell its own copy of a payload before it is modified.
+    template<typename T>
+    static T* _unshare(shared_ptr<T> &payload)
+    {
+        if (payload && payload.use_count() > 1)
+            payload = make_shared<T>(*payload);
+        return payload.get();
+    }
+
     dungeon_feature_type _feat:8;
     colour_t _feat_colour;
     trap_type _trap:8;
-    cloud_info* _cloud;
-    item_def* _item;
-    monster_info* _mons;
+    shared_ptr<cloud_info> _cloud;
+    shared_ptr<item_def> _item;
+    shared_ptr<monster_info> _mons;
 };
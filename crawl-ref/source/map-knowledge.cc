@@ -167,9 +167,10 @@ void map_cell::set_detected_item()
 {
     clear_item();
     flags |= MAP_DETECTED_ITEM;
-    _item = new item_def();
-    _item->base_type = OBJ_DETECTED;
-    _item->rnd       = 1;
+    auto item = make_shared<item_def>();
+    item->base_type = OBJ_DETECTED;
+    item->rnd       = 1;
+    _item = move(item);
 }
 
 static bool _floor_mf(map_feature mf)
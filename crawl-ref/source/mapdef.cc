@@ -13,6 +13,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
+#include <unordered_map>
 
 #include "abyss.h"
 #include "artefact.h"
@@ -81,6 +82,118 @@ void tag_profile_out()
 }
 #endif
 
+///////////////////////////////////////////////////////////////////////////
+// Map tag interning
+
+// Must match core_map_tag.
+static const char *core_map_tag_names[] =
+{
+    "dummy", "minivault", "overwritable", "extra", "unrand", "place_unique",
+    "tutorial", "no_descent", "allow_dup", "luniq",
+};
+COMPILE_CHECK(ARRAYSZ(core_map_tag_names) == NUM_CORE_MAP_TAGS);
+
+struct map_tag_table
+{
+    unordered_map<string, map_tag_id> ids;
+    vector<string> names;
+    vector<bool> uniq;
+
+    map_tag_table()
+    {
+        for (const char *name : core_map_tag_names)
+            add(name);
+    }
+
+    map_tag_id add(const string &tag)
+    {
+        ASSERT(names.size() < MAP_TAG_NONE);
+        const map_tag_id id = names.size();
+        ids[tag] = id;
+        names.push_back(tag);
+        uniq.push_back(starts_with(tag, "uniq_") || starts_with(tag, "luniq_"));
+        return id;
+    }
+};
+
+static map_tag_table &_map_tags()
+{
+    static map_tag_table table;
+    return table;
+}
+
+map_tag_id intern_map_tag(const string &tag)
+{
+    map_tag_table &table = _map_tags();
+    auto it = table.ids.find(tag);
+    return it != table.ids.end() ? it->second : table.add(tag);
+}
+
+map_tag_id find_map_tag(const string &tag)
+{
+    const map_tag_table &table = _map_tags();
+    auto it = table.ids.find(tag);
+    return it != table.ids.end() ? it->second : MAP_TAG_NONE;
+}
+
+const string &map_tag_name(map_tag_id tag)
+{
+    const map_tag_table &table = _map_tags();
+    ASSERT(tag < table.names.size());
+    return table.names[tag];
+}
+
+bool map_tag_is_uniq(map_tag_id tag)
+{
+    const map_tag_table &table = _map_tags();
+    return tag < table.uniq.size() && table.uniq[tag];
+}
+
+bool map_tag_set::insert(map_tag_id tag)
+{
+    ASSERT(tag != MAP_TAG_NONE);
+    auto it = lower_bound(ids.begin(), ids.end(), tag);
+    if (it != ids.end() && *it == tag)
+        return false;
+    ids.insert(it, tag);
+    mask |= _bit(tag);
+    return true;
+}
+
+bool map_tag_set::erase(map_tag_id tag)
+{
+    auto it = lower_bound(ids.begin(), ids.end(), tag);
+    if (it == ids.end() || *it != tag)
+        return false;
+    ids.erase(it);
+    mask = 0;
+    for (map_tag_id id : ids)
+        mask |= _bit(id);
+    return true;
+}
+
+void map_tag_set::clear()
+{
+    ids.clear();
+    mask = 0;
+}
+
+map_tag_set parse_map_tags(const string &tags)
+{
+    map_tag_set result;
+    for (const string &tag : split_string(" ", tags))
+        result.insert(intern_map_tag(tag));
+    return result;
+}
+
+vector<map_tag_id> find_map_tags(const string &tags)
+{
+    vector<map_tag_id> result;
+    for (const string &tag : split_string(" ", tags))
+        result.push_back(find_map_tag(tag));
+    return result;
+}
+
 static const char *map_section_names[] =
 {
     "",
@@ -2289,17 +2402,29 @@ void map_def::reload_epilogue()
 
 bool map_def::map_already_used() const
 {
-    return get_uniq_map_names().count(name)
-           || env.level_uniq_maps.find(name) !=
-               env.level_uniq_maps.end()
-           || env.new_used_subvault_names.find(name) !=
-               env.new_used_subvault_names.end()
-           || has_any_tag(get_uniq_map_tags().begin(),
-                          get_uniq_map_tags().end())
-           || has_any_tag(env.level_uniq_map_tags.begin(),
-                          env.level_uniq_map_tags.end())
-           || has_any_tag(env.new_used_subvault_tags.begin(),
-                          env.new_used_subvault_tags.end());
+    if (get_uniq_map_names().count(name)
+        || env.level_uniq_maps.find(name) != env.level_uniq_maps.end()
+        || env.new_used_subvault_names.find(name) !=
+            env.new_used_subvault_names.end())
+    {
+        return true;
+    }
+
+    // The used tag sets only ever hold uniq_ and luniq_ tags, so checking
+    // this map's own (usually zero) uniq tags against them is enough.
+    for (map_tag_id tag : tags)
+    {
+        if (!map_tag_is_uniq(tag))
+            continue;
+        const string &tagname = map_tag_name(tag);
+        if (get_uniq_map_tags().count(tagname)
+            || env.level_uniq_map_tags.count(tagname)
+            || env.new_used_subvault_tags.count(tagname))
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
 bool map_def::valid_item_array_glyph(int gly)
@@ -2785,9 +2910,9 @@ string map_def::validate_map_placeable()
     // Ok, the map wants to be placed by tag. In this case it should have
     // at least one tag that's not a map flag.
     bool has_selectable_tag = false;
-    for (const string &piece : tags)
+    for (map_tag_id piece : tags)
     {
-        if (_map_tag_is_selectable(piece))
+        if (_map_tag_is_selectable(map_tag_name(piece)))
         {
             has_selectable_tag = true;
             break;
@@ -2957,8 +3082,8 @@ string map_def::validate_map_def(const depth_ranges &default_depths)
 
     // Encompass vaults, pure subvaults, and dummy vaults are exempt from
     // exit-checking.
-    if (orient != MAP_ENCOMPASS && !has_tag("unrand") && !has_tag("dummy")
-        && !has_tag("no_exits") && map.width() > 0 && map.height() > 0)
+    if (orient != MAP_ENCOMPASS && !has_tag(MAP_TAG_UNRAND)
+        && !has_tag(MAP_TAG_DUMMY) && !has_tag("no_exits") && map.width() > 0 && map.height() > 0)
     {
         if (!has_exit())
         {
@@ -2990,15 +3115,15 @@ bool map_def::has_depth() const
 
 void map_def::update_cached_tags()
 {
-    cache_minivault = has_tag("minivault");
-    cache_overwritable = has_tag("overwritable");
-    cache_extra = has_tag("extra");
+    cache_minivault = has_tag(MAP_TAG_MINIVAULT);
+    cache_overwritable = has_tag(MAP_TAG_OVERWRITABLE);
+    cache_extra = has_tag(MAP_TAG_EXTRA);
 }
 
 bool map_def::is_minivault() const
 {
 #ifdef DEBUG_TAG_PROFILING
-    ASSERT(cache_minivault == has_tag("minivault"));
+    ASSERT(cache_minivault == has_tag(MAP_TAG_MINIVAULT));
 #endif
     return cache_minivault;
 }
@@ -3011,7 +3136,7 @@ bool map_def::is_overwritable_layout() const
     // In almost all cases "overwritable" and "layout" coincide, but there are
     // cases where they don't...
 #ifdef DEBUG_TAG_PROFILING
-    ASSERT(cache_overwritable == has_tag("overwritable"));
+    ASSERT(cache_overwritable == has_tag(MAP_TAG_OVERWRITABLE));
 #endif
     return cache_overwritable;
 }
@@ -3019,7 +3144,7 @@ bool map_def::is_overwritable_layout() const
 bool map_def::is_extra_vault() const
 {
 #ifdef DEBUG_TAG_PROFILING
-    ASSERT(cache_extra == has_tag("extra"));
+    ASSERT(cache_extra == has_tag(MAP_TAG_EXTRA));
 #endif
     return cache_extra;
 }
@@ -3326,24 +3451,30 @@ void map_def::fixup()
 
 bool map_def::has_all_tags(const string &tagswanted) const
 {
-    const auto &tags_set = parse_tags(tagswanted);
-    return has_all_tags(tags_set.begin(), tags_set.end());
+    const vector<map_tag_id> wanted = find_map_tags(tagswanted);
+    return has_all_tags(wanted.begin(), wanted.end());
 }
 
-bool map_def::has_tag(const string &tagwanted) const
+bool map_def::has_tag(map_tag_id tagwanted) const
 {
 #ifdef DEBUG_TAG_PROFILING
-    _profile_inc_tag(tagwanted);
+    if (tagwanted != MAP_TAG_NONE)
+        _profile_inc_tag(map_tag_name(tagwanted));
 #endif
-    return tags.count(tagwanted) > 0;
+    return tags.contains(tagwanted);
+}
+
+bool map_def::has_tag(const string &tagwanted) const
+{
+    return has_tag(find_map_tag(tagwanted));
 }
 
 bool map_def::has_tag_prefix(const string &prefix) const
 {
     if (prefix.empty())
         return false;
-    for (const auto &tag : tags)
-        if (starts_with(tag, prefix))
+    for (map_tag_id tag : tags)
+        if (starts_with(map_tag_name(tag), prefix))
             return true;
     return false;
 }
@@ -3352,13 +3483,13 @@ bool map_def::has_tag_suffix(const string &suffix) const
 {
     if (suffix.empty())
         return false;
-    for (const auto &tag : tags)
-        if (ends_with(tag, suffix))
+    for (map_tag_id tag : tags)
+        if (ends_with(map_tag_name(tag), suffix))
             return true;
     return false;
 }
 
-const unordered_set<string> map_def::get_tags_unsorted() const
+const map_tag_set &map_def::get_tag_ids() const
 {
     return tags;
 }
@@ -3367,24 +3498,25 @@ const vector<string> map_def::get_tags() const
 {
     // this might seem inefficient, but get_tags is not called very much; the
     // hotspot revealed by profiling is actually has_tag checks.
-    vector<string> result(tags.begin(), tags.end());
+    vector<string> result;
+    for (map_tag_id tag : tags)
+        result.push_back(map_tag_name(tag));
     sort(result.begin(), result.end());
     return result;
 }
 
 void map_def::add_tags(const string &tag)
 {
-    auto parsed_tags = parse_tags(tag);
-    tags.insert(parsed_tags.begin(), parsed_tags.end());
+    for (const string &t : split_string(" ", tag))
+        tags.insert(intern_map_tag(t));
     update_cached_tags();
 }
 
 bool map_def::remove_tags(const string &tag)
 {
     bool removed = false;
-    auto parsed_tags = parse_tags(tag);
-    for (auto &t : parsed_tags)
-        removed = tags.erase(t) || removed; // would iterator overload be ok?
+    for (map_tag_id t : find_map_tags(tag))
+        removed = tags.erase(t) || removed;
     update_cached_tags();
     return removed;
 }
@@ -3459,13 +3591,16 @@ string map_def::subvault_from_tagstring(const string &sub)
 
 static void _register_subvault(const string &name, const string &spaced_tags)
 {
-    auto parsed_tags = parse_tags(spaced_tags);
-    if (!parsed_tags.count("allow_dup") || parsed_tags.count("luniq"))
+    const map_tag_set parsed_tags = parse_map_tags(spaced_tags);
+    if (!parsed_tags.contains(MAP_TAG_ALLOW_DUP)
+        || parsed_tags.contains(MAP_TAG_LUNIQ))
+    {
         env.new_used_subvault_names.insert(name);
+    }
 
-    for (const string &tag : parsed_tags)
-        if (starts_with(tag, "uniq_") || starts_with(tag, "luniq_"))
-            env.new_used_subvault_tags.insert(tag);
+    for (map_tag_id tag : parsed_tags)
+        if (map_tag_is_uniq(tag))
+            env.new_used_subvault_tags.insert(map_tag_name(tag));
 }
 
 static void _reset_subvault_stack(const int reg_stack)
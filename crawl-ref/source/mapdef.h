@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdio>
 #include <memory>
 #include <stdexcept>
@@ -1085,6 +1087,72 @@ struct subvault_place
     void set_subvault(const map_def &);
 };
 
+/////////////////////////////////////////////////////////////////////////////
+// Map tags are interned: every distinct tag string is given a small id the
+// first time it is seen, and maps store and compare ids rather than strings.
+
+typedef uint16_t map_tag_id;
+static const map_tag_id MAP_TAG_NONE = UINT16_MAX;
+
+// Tags tested for every candidate map during vault selection. These are
+// interned first, so their ids are constants.
+enum core_map_tag : map_tag_id
+{
+    MAP_TAG_DUMMY,
+    MAP_TAG_MINIVAULT,
+    MAP_TAG_OVERWRITABLE,
+    MAP_TAG_EXTRA,
+    MAP_TAG_UNRAND,
+    MAP_TAG_PLACE_UNIQUE,
+    MAP_TAG_TUTORIAL,
+    MAP_TAG_NO_DESCENT,
+    MAP_TAG_ALLOW_DUP,
+    MAP_TAG_LUNIQ,
+    NUM_CORE_MAP_TAGS
+};
+
+map_tag_id intern_map_tag(const string &tag);
+// Like intern_map_tag(), but returns MAP_TAG_NONE for a tag no map has.
+map_tag_id find_map_tag(const string &tag);
+const string &map_tag_name(map_tag_id tag);
+// True for uniq_ and luniq_ tags.
+bool map_tag_is_uniq(map_tag_id tag);
+
+// A small set of interned tags: a sorted vector of ids, with a 64-bit
+// summary mask so that most failed lookups don't have to search it.
+class map_tag_set
+{
+public:
+    map_tag_set() : mask(0) { }
+
+    bool contains(map_tag_id tag) const
+    {
+        return tag != MAP_TAG_NONE && (mask & _bit(tag))
+               && binary_search(ids.begin(), ids.end(), tag);
+    }
+
+    bool insert(map_tag_id tag);
+    bool erase(map_tag_id tag);
+    void clear();
+
+    bool empty() const { return ids.empty(); }
+    size_t size() const { return ids.size(); }
+    vector<map_tag_id>::const_iterator begin() const { return ids.begin(); }
+    vector<map_tag_id>::const_iterator end() const { return ids.end(); }
+
+private:
+    static uint64_t _bit(map_tag_id tag) { return uint64_t(1) << (tag & 63); }
+
+    uint64_t mask;
+    vector<map_tag_id> ids;
+};
+
+// Split a space-separated tag string, interning every tag in it.
+map_tag_set parse_map_tags(const string &tags);
+// Split a space-separated tag string without interning anything; tags no
+// map has come back as MAP_TAG_NONE.
+vector<map_tag_id> find_map_tags(const string &tags);
+
 /////////////////////////////////////////////////////////////////////////////
 // map_def: map definitions for maps loaded from .des files.
 //
@@ -1156,7 +1224,7 @@ public:
     string          file;
 
 private:
-    unordered_set<string>     tags;
+    map_tag_set     tags;
     // This map has been loaded from an index, and not fully realised.
     bool            index_only;
     mutable long    cache_offset;
@@ -1261,6 +1329,7 @@ public:
     bool is_minivault() const;
     bool is_overwritable_layout() const;
     bool is_extra_vault() const;
+    bool has_tag(map_tag_id tagwanted) const;
     bool has_tag(const string &tagwanted) const;
     bool has_tag_prefix(const string &tag) const;
     bool has_tag_suffix(const string &suffix) const;
@@ -1287,7 +1356,7 @@ public:
     }
 
     const vector<string> get_tags() const;
-    const unordered_set<string> get_tags_unsorted() const;
+    const map_tag_set &get_tag_ids() const;
     void add_tags(const string &tag);
     void set_tags(const string &tag);
     bool remove_tags(const string &tag);
@@ -26,6 +26,7 @@
 #include "files.h"
 #include "mapmark.h"
 #include "message.h"
+#include "startup-profile.h"
 #include "state.h"
 #include "stringutil.h"
 #include "syscalls.h"
@@ -705,35 +706,57 @@ static map_section_type _apply_vault_definition(
 ///////////////////////////////////////////////////////////////////////////
 // Map lookups
 
-static bool _map_matches_layout_type(const map_def &map)
+typedef vector<pair<map_tag_id, map_tag_id>> layout_tag_list;
+
+// The layout_ and nolayout_ tags for each of the current level's layout
+// types, in order.
+static layout_tag_list _level_layout_tags()
+{
+    layout_tag_list tags;
+    for (const auto &layout : env.level_layout_types)
+    {
+        tags.emplace_back(find_map_tag("layout_" + layout),
+                          find_map_tag("nolayout_" + layout));
+    }
+    return tags;
+}
+
+static bool _map_matches_layout_type(const map_def &map,
+                                     const layout_tag_list &layout_tags)
 {
     bool permissive = false;
-    if (env.level_layout_types.empty()
+    if (layout_tags.empty()
         || (!map.has_tag_prefix("layout_")
             && !(permissive = map.has_tag_prefix("nolayout_"))))
     {
         return true;
     }
 
-    for (const auto &layout : env.level_layout_types)
+    for (const auto &tags : layout_tags)
     {
-        if (map.has_tag("layout_" + layout))
+        if (map.has_tag(tags.first))
             return true;
-        else if (map.has_tag("nolayout_" + layout))
+        else if (map.has_tag(tags.second))
             return false;
     }
 
     return permissive;
 }
 
-static bool _map_matches_species(const map_def &map)
+// The tag that excludes a map for the player's species.
+static map_tag_id _species_exclusion_tag()
 {
     if (!species::is_valid(you.species))
-        return true;
-    return !map.has_tag("no_species_"
+        return MAP_TAG_NONE;
+    return find_map_tag("no_species_"
            + lowercase_string(species::get_abbrev(you.species)));
 }
 
+static bool _map_matches_species(const map_def &map, map_tag_id species_tag)
+{
+    return !map.has_tag(species_tag);
+}
+
 const map_def *find_map_by_name(const string &name)
 {
     for (const map_def &mapdef : vdefs)
@@ -767,12 +790,12 @@ mapref_vector find_maps_for_tag(const string &tag,
 {
     mapref_vector maps;
     level_id place = level_id::current();
-    unordered_set<string> tag_set = parse_tags(tag);
+    const vector<map_tag_id> tag_ids = find_map_tags(tag);
 
     for (const map_def &mapdef : vdefs)
     {
-        if (mapdef.has_all_tags(tag_set.begin(), tag_set.end())
-            && !mapdef.has_tag("dummy")
+        if (mapdef.has_all_tags(tag_ids.begin(), tag_ids.end())
+            && !mapdef.has_tag(MAP_TAG_DUMMY)
             && (!check_depth || _debug_ignore_depth
                 || !mapdef.has_depth()
                 || mapdef.is_usable_in(place))
@@ -846,7 +869,10 @@ private:
           mini(_mini), extra(_extra),
           check_depth(_check_depth),
           check_layout((sel == DEPTH || sel == DEPTH_AND_CHANCE)
-                    && place == level_id::current())
+                    && place == level_id::current()),
+          tag_ids(find_map_tags(_tag)),
+          species_tag(_species_exclusion_tag()),
+          layout_tags(_level_layout_tags())
     {
         if (_typ == PLACE)
             ignore_chance = true;
@@ -864,6 +890,12 @@ public:
     const maybe_bool extra;
     const bool check_depth;
     const bool check_layout;
+
+private:
+    // Looked up once per selection rather than once per candidate map.
+    const vector<map_tag_id> tag_ids;
+    const map_tag_id species_tag;
+    const layout_tag_list layout_tags;
 };
 
 static bool _overflow_range(level_id place)
@@ -880,14 +912,15 @@ bool map_selector::depth_selectable(const map_def &mapdef) const
            // Some tagged levels cannot be selected as random
            // maps in a specific depth:
            && !mapdef.has_tag_suffix("entry")
-           && !mapdef.has_tag("unrand")
-           && !mapdef.has_tag("place_unique")
-           && !mapdef.has_tag("tutorial")
+           && !mapdef.has_tag(MAP_TAG_UNRAND)
+           && !mapdef.has_tag(MAP_TAG_PLACE_UNIQUE)
+           && !mapdef.has_tag(MAP_TAG_TUTORIAL)
            && (!mapdef.has_tag_prefix("temple_")
                || !_overflow_range(place)
                   && mapdef.has_tag_prefix("uniq_altar_"))
-           && _map_matches_species(mapdef)
-           && (!check_layout || _map_matches_layout_type(mapdef));
+           && _map_matches_species(mapdef, species_tag)
+           && (!check_layout
+               || _map_matches_layout_type(mapdef, layout_tags));
 }
 
 static bool _is_extra_compatible(maybe_bool want_extra, bool have_extra)
@@ -899,7 +932,7 @@ static bool _is_extra_compatible(maybe_bool want_extra, bool have_extra)
 
 bool map_selector::accept(const map_def &mapdef) const
 {
-    if (crawl_state.game_is_descent() && mapdef.has_tag("no_descent"))
+    if (crawl_state.game_is_descent() && mapdef.has_tag(MAP_TAG_NO_DESCENT))
         return false;
 
     switch (sel)
@@ -914,7 +947,7 @@ bool map_selector::accept(const map_def &mapdef) const
         return mapdef.is_minivault() == mini
                && _is_extra_compatible(extra, mapdef.is_extra_vault())
                && mapdef.place.is_usable_in(place)
-               && _map_matches_layout_type(mapdef)
+               && _map_matches_layout_type(mapdef, layout_tags)
                && !mapdef.map_already_used();
 
     case DEPTH:
@@ -922,7 +955,7 @@ bool map_selector::accept(const map_def &mapdef) const
         const map_chance chance(mapdef.chance(place));
         return mapdef.is_minivault() == mini
                && _is_extra_compatible(extra, mapdef.is_extra_vault())
-               && (!chance.valid() || mapdef.has_tag("dummy"))
+               && (!chance.valid() || mapdef.has_tag(MAP_TAG_DUMMY))
                && depth_selectable(mapdef)
                && !mapdef.map_already_used();
     }
@@ -932,19 +965,20 @@ bool map_selector::accept(const map_def &mapdef) const
         const map_chance chance(mapdef.chance(place));
         // Only vaults with valid chance
         return chance.valid()
-               && !mapdef.has_tag("dummy")
+               && !mapdef.has_tag(MAP_TAG_DUMMY)
                && depth_selectable(mapdef)
                && _is_extra_compatible(extra, mapdef.is_extra_vault())
                && !mapdef.map_already_used();
     }
 
     case TAG:
-        return mapdef.has_all_tags(tag) // allow multiple tags, for temple overflow vaults
+        // allow multiple tags, for temple overflow vaults
+        return mapdef.has_all_tags(tag_ids.begin(), tag_ids.end())
                && (!check_depth || _debug_ignore_depth
                    || !mapdef.has_depth()
                    || mapdef.is_usable_in(place))
-               && _map_matches_species(mapdef)
-               && _map_matches_layout_type(mapdef)
+               && _map_matches_species(mapdef, species_tag)
+               && _map_matches_layout_type(mapdef, layout_tags)
                && !mapdef.map_already_used();
 
     default:
@@ -1171,7 +1205,7 @@ _random_map_in_list(const map_selector &sel,
     }
 
     if (!sel.preserve_dummy && chosen_map
-        && chosen_map->has_tag("dummy"))
+        && chosen_map->has_tag(MAP_TAG_DUMMY))
     {
         chosen_map = nullptr;
     }
@@ -1521,12 +1555,16 @@ void read_map(const string &file)
 
 void read_maps()
 {
-    if (dlua.execfile("dlua/loadmaps.lua", true, true, true))
-        end(1, false, "Lua error: %s", dlua.error.c_str());
+    {
+        startup_phase phase("des files");
+        if (dlua.execfile("dlua/loadmaps.lua", true, true, true))
+            end(1, false, "Lua error: %s", dlua.error.c_str());
+    }
 
     lc_loaded_maps.clear();
 
     {
+        startup_phase phase("map sanity");
         unwind_var<FixedVector<int, NUM_BRANCHES> > depths(brdepth);
         // let the sanity check place maps
         for (branch_iterator it; it; ++it)
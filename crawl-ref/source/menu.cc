@@ -105,6 +105,11 @@
 
 using namespace ui;
 
+#ifdef USE_TILE_WEB
+// Entries sent at a time by menus with an entry source.
+#define WEBTILES_MENU_CHUNK 100
+#endif
+
 class UIMenu : public Widget
 {
     friend class UIMenuPopup;
@@ -174,13 +179,15 @@ protected:
     int m_scroll_context = 0;
 
     int m_num_columns = 1;
-    int m_nat_column_width; // set by do_layout()
+    int m_nat_column_width = 0; // set by do_layout()
     void do_layout(int mw, int num_columns, bool just_checking=false);
     struct MenuItemInfo {
         int x, y, row, column;
         formatted_string text;
 #ifdef USE_TILE_LOCAL
         vector<tile_def> tiles;
+#else
+        bool made; // text and heading are filled in from the entry
 #endif
         bool heading;
     };
@@ -214,16 +221,32 @@ public:
     static constexpr int pad_right = 2; // no vertical padding for console
 
     int m_shown_height {0};
+
+    int item_screen_row(int index, int vis_min);
+    void expose_item(int index);
 #endif
+    void fill_item_info(int index);
 };
 
 void UIMenu::update_items()
 {
     _invalidate_sizereq();
+    _queue_allocation();
 
     item_info.resize(m_menu->items.size());
     for (unsigned int i = 0; i < m_menu->items.size(); ++i)
+    {
+#ifndef USE_TILE_LOCAL
+        // Console layout doesn't need entries that haven't been made yet;
+        // _render() makes them as they scroll into view.
+        if (!m_menu->items[i])
+        {
+            item_info[i].made = false;
+            continue;
+        }
+#endif
         update_item(i);
+    }
 
 #ifdef USE_TILE_LOCAL
     // update m_draw_tiles
@@ -339,16 +362,40 @@ void UIMenu::get_item_region(int index, int *y1, int *y2)
 
 void UIMenu::update_item(int index)
 {
+    ASSERT(index < static_cast<int>(m_menu->items.size()));
+#ifndef USE_TILE_LOCAL
+    const bool laid_out = m_nat_column_width > 0
+                          && item_info.size() == m_menu->items.size();
+    const bool was_heading = laid_out && item_info[index].heading;
+#endif
+    item_info.resize(m_menu->items.size());
+    fill_item_info(index);
+
+#ifndef USE_TILE_LOCAL
+    const auto& entry = item_info[index];
+    // Console entries are one row each, so if this one is the same kind as
+    // before and still fits its column, the layout is unchanged and only
+    // its row needs redrawing.
+    if (laid_out && entry.heading == was_heading
+        && (entry.heading || static_cast<int>(entry.text.width())
+                             + pad_right <= m_nat_column_width))
+    {
+        expose_item(index);
+        return;
+    }
+#endif
+
     _invalidate_sizereq();
     _queue_allocation();
+}
 
-    ASSERT(index < static_cast<int>(m_menu->items.size()));
-    const MenuEntry *me = m_menu->items[index];
+/// Fill in an item's text and heading state from its (possibly new) entry.
+void UIMenu::fill_item_info(int index)
+{
+    const MenuEntry *me = m_menu->get_entry(index);
     int colour = m_menu->item_colour(me);
     string text = me->get_text();
 
-    item_info.resize(m_menu->items.size());
-
     auto& entry = item_info[index];
     entry.text.clear();
     entry.text.textcolour(colour);
@@ -357,6 +404,8 @@ void UIMenu::update_item(int index)
 #ifdef USE_TILE_LOCAL
     entry.tiles.clear();
     me->get_tiles(entry.tiles);
+#else
+    entry.made = true;
 #endif
 }
 
@@ -518,6 +567,9 @@ void UIMenu::do_layout(int mw, int num_columns, bool just_checking)
             column_width = max(column_width, text_width + pad_right);
         }
     }
+    // unmade entries might be any width
+    if (m_menu->entry_source)
+        column_width = max_column_width;
     m_height = row + 1;
     // should this update the region??
     m_nat_column_width = max(min_column_width, min(column_width, max_column_width));
@@ -568,14 +620,31 @@ void UIMenu::_render()
 
     int vis_min, vis_max;
     is_visible_item_range(&vis_min, &vis_max);
-    const int scroll = m_menu->m_ui.scroller->get_scroll();
+    const Region clip = ui::render_clip();
 
     for (int i = vis_min; i < vis_max; i++)
     {
-        const MenuEntry *me = m_menu->items[i];
-        int y = item_info[i].y - item_info[vis_min].y + 1;
+        // Rows outside the damaged part of the screen are still up to date.
+        const int y = item_screen_row(i, vis_min);
+        if (y < clip.y || y >= clip.ey())
+            continue;
+
+        // update_items() skipped entries that hadn't been made yet, so
+        // catch up on them here. A heading takes a whole row, which the
+        // layout assumed it didn't, so lay out again to place it.
+        if (!item_info[i].made)
+        {
+            fill_item_info(i);
+            if (item_info[i].heading)
+            {
+                _invalidate_sizereq();
+                _queue_allocation();
+            }
+        }
+
+        const MenuEntry *me = m_menu->get_entry(i);
         int x = item_info[i].x + item_info[i].column * m_nat_column_width;
-        cgotoxy(m_region.x + x + 1, m_region.y + scroll + y);
+        cgotoxy(m_region.x + x + 1, y + 1);
         const int col = m_menu->item_colour(me);
         textcolour(col);
 
@@ -765,10 +834,12 @@ int UIMenuPopup::_calc_columns(int mw) const
     }
 #else
     int max_entry_text = min_column_width;
-    for (size_t i = 0; i < m_menu->items.size(); ++i)
+    for (const MenuEntry *me : m_menu->items)
     {
+        if (!me)
+            continue;
         max_entry_text = max(max_entry_text,
-                static_cast<int>(m_menu->items[i]->get_text().size())
+                static_cast<int>(me->get_text().size())
                 + m_menu->m_ui.menu->pad_right);
     }
 #endif
@@ -898,15 +969,47 @@ void UIMenu::_allocate_region()
 
 void UIMenu::set_hovered_entry(int i)
 {
-    m_hover_idx = i;
-
 #ifdef USE_TILE_LOCAL
+    m_hover_idx = i;
     if (row_heights.size() > 0) // check for initial layout
         pack_buffers();
-#endif
     _expose();
+#else
+    // Only the rows losing and gaining the highlight change.
+    if (m_hover_idx >= 0)
+        expose_item(m_hover_idx);
+    m_hover_idx = i;
+    if (m_hover_idx >= 0)
+        expose_item(m_hover_idx);
+#endif
+}
+
+#ifndef USE_TILE_LOCAL
+/// The screen row (from 0) that _render() draws an item on.
+int UIMenu::item_screen_row(int index, int vis_min)
+{
+    const int scroll = m_menu->m_ui.scroller->get_scroll();
+    return m_region.y + scroll + item_info[index].y - item_info[vis_min].y;
 }
 
+void UIMenu::expose_item(int index)
+{
+    int vis_min, vis_max;
+    is_visible_item_range(&vis_min, &vis_max);
+    if (index >= vis_max || vis_min >= vis_max)
+    {
+        // not laid out yet, or out of date: redraw the lot
+        _expose();
+        return;
+    }
+    if (index < vis_min)
+        return;
+
+    _expose_region({m_region.x, item_screen_row(index, vis_min),
+                    m_region.width, 1});
+}
+#endif
+
 #ifdef USE_TILE_LOCAL
 void UIMenu::update_hovered_entry(bool force)
 {
@@ -920,7 +1023,7 @@ void UIMenu::update_hovered_entry(bool force)
         const auto& entry = item_info[i];
         if (entry.heading)
             continue;
-        const auto me = m_menu->items[i];
+        const auto me = m_menu->get_entry(i);
         if (me->hotkeys_count() == 0 && !force)
             continue;
         const int w = m_region.width / m_num_columns;
@@ -1020,7 +1123,7 @@ bool UIMenu::on_event(const Event& ev)
         // use the "real" hover idx, a menu item that the mouse is currently
         // positioned over.
         int entry = m_real_hover_idx;
-        if (entry != -1 && m_menu->items[entry]->hotkeys_count() > 0)
+        if (entry != -1 && m_menu->get_entry(entry)->hotkeys_count() > 0)
             key = event.button() == MouseEvent::Button::Left ? CK_MOUSE_B1 : CK_MOUSE_B2;
 
         m_mouse_pressed = false;
@@ -1061,7 +1164,7 @@ void UIMenu::pack_buffers()
     for (int i = vis_min; i < vis_max; ++i)
     {
         const auto& entry = item_info[i];
-        const auto me = m_menu->items[i];
+        const auto me = m_menu->get_entry(i);
         const int entry_x = entry.column * col_width;
         const int entry_ex = entry_x + col_width;
         const int entry_h = row_heights[entry.row+1] - row_heights[entry.row];
@@ -1241,6 +1344,8 @@ Menu::~Menu()
 void Menu::clear()
 {
     deleteAll(items);
+    entry_source = nullptr;
+    entry_source_hotkey = nullptr;
     m_ui.menu->_queue_allocation();
 }
 
@@ -1470,10 +1575,46 @@ void Menu::set_title(const string &t, bool first, bool indent)
 
 void Menu::add_entry(MenuEntry *entry)
 {
+    ASSERT(!entry_source);
     entry->tag = tag;
     items.push_back(entry);
 }
 
+/**
+ * Fill the menu with entries that are made only when needed, for lists too
+ * long to build up front. Entry i is made by make_entry(i) the first time
+ * something asks for it: usually when it scrolls into view, though hotkeys,
+ * searches and header cycling may make others. Replaces any existing
+ * entries; add_entry() can't be used afterwards.
+ *
+ * If entry_hotkey is given, entry_hotkey(i) is the one hotkey that entry i
+ * will have (0 for none, or for headers), so that hotkeys can be matched
+ * without making every entry. The regex filter still makes them all.
+ */
+void Menu::set_entry_source(int count, function<MenuEntry*(int)> make_entry,
+                            function<int(int)> entry_hotkey)
+{
+    deleteAll(items);
+    items.resize(count, nullptr);
+    entry_source = make_entry;
+    entry_source_hotkey = entry_hotkey;
+    m_ui.menu->_queue_allocation();
+}
+
+/// Get entry index, making it first if it comes from an entry source.
+MenuEntry *Menu::get_entry(int index) const
+{
+    ASSERT_RANGE(index, 0, (int)items.size());
+    MenuEntry *&entry = const_cast<Menu *>(this)->items[index];
+    if (!entry)
+    {
+        ASSERT(entry_source);
+        entry = entry_source(index);
+        entry->tag = tag;
+    }
+    return entry;
+}
+
 void Menu::reset()
 {
     m_ui.scroller->set_scroll(0);
@@ -1501,12 +1642,12 @@ vector<MenuEntry *> Menu::show(bool reuse_selections)
         {
             // MF_START_AT_END overrides a manually set initial hover
             set_hovered(static_cast<int>(items.size()) - 1);
-            if (items[last_hovered]->level != MEL_ITEM)
+            if (get_entry(last_hovered)->level != MEL_ITEM)
                 cycle_hover(true);
         }
     }
     else if (is_set(MF_INIT_HOVER)
-        && (last_hovered < 0 || items[last_hovered]->level != MEL_ITEM)) // XX check hotkeys?
+        && (last_hovered < 0 || get_entry(last_hovered)->level != MEL_ITEM)) // XX check hotkeys?
     {
         cycle_hover();
     }
@@ -1594,8 +1735,8 @@ bool Menu::filter_with_regex(const char *re)
     text_pattern tpat(re, true);
     for (unsigned int i = 0; i < items.size(); ++i)
     {
-        if (items[i]->level == MEL_ITEM
-            && tpat.matches(items[i]->get_text()))
+        if (get_entry(i)->level == MEL_ITEM
+            && tpat.matches(get_entry(i)->get_text()))
         {
             select_index(i);
             if (flags & MF_SINGLESELECT)
@@ -1764,7 +1905,7 @@ bool Menu::process_command(command_type cmd)
         if (is_set(MF_ARROWS_SELECT) && items.size())
         {
             set_hovered(0);
-            if (items[last_hovered]->level != MEL_ITEM)
+            if (get_entry(last_hovered)->level != MEL_ITEM)
                 cycle_hover();
         }
         break;
@@ -1781,7 +1922,7 @@ bool Menu::process_command(command_type cmd)
             if (is_set(MF_ARROWS_SELECT))
             {
                 set_hovered(static_cast<int>(items.size()) - 1);
-                if (items[last_hovered]->level != MEL_ITEM)
+                if (get_entry(last_hovered)->level != MEL_ITEM)
                     cycle_hover(true);
 
             }
@@ -2106,8 +2247,9 @@ void Menu::get_selected(vector<MenuEntry*> *selected) const
 {
     selected->clear();
 
+    // entries that haven't been made yet can't have been selected
     for (MenuEntry *item : items)
-        if (item->selected())
+        if (item && item->selected())
             selected->push_back(item);
 }
 
@@ -2115,9 +2257,9 @@ void Menu::deselect_all(bool update_view)
 {
     for (int i = 0, count = items.size(); i < count; ++i)
     {
-        if (items[i]->level == MEL_ITEM && items[i]->selected())
+        if (items[i] && items[i]->level == MEL_ITEM && items[i]->selected())
         {
-            items[i]->select(0);
+            get_entry(i)->select(0);
             if (update_view)
             {
                 m_ui.menu->update_item(i);
@@ -2140,8 +2282,8 @@ int Menu::get_first_visible(bool skip_init_headers, int col) const
         if (item_y1 >= y)
         {
             if (skip_init_headers
-                && (items[i]->level == MEL_TITLE
-                    || items[i]->level == MEL_SUBTITLE))
+                && (get_entry(i)->level == MEL_TITLE
+                    || get_entry(i)->level == MEL_SUBTITLE))
             {
                 // when using this to determine e.g. scroll position, it is
                 // useful to ignore visible headers
@@ -2164,10 +2306,21 @@ int Menu::get_first_visible(bool skip_init_headers, int col) const
 
 bool Menu::is_hotkey(int i, int key)
 {
-    bool ishotkey = items[i]->is_hotkey(key);
+    bool ishotkey = !items[i] && entry_source_hotkey
+                    ? key && entry_source_hotkey(i) == key
+                    : get_entry(i)->is_hotkey(key);
     return ishotkey && (!is_set(MF_SELECT_BY_PAGE) || in_page(i));
 }
 
+/// The first hotkey of item i, or 0 if it isn't an item or has none.
+int Menu::primary_hotkey(int i) const
+{
+    if (!items[i] && entry_source_hotkey)
+        return entry_source_hotkey(i);
+    const MenuEntry *me = get_entry(i);
+    return me->level == MEL_ITEM && !me->hotkeys.empty() ? me->hotkeys[0] : 0;
+}
+
 /// find the first item (if any) that has hotkey `key`.
 int Menu::hotkey_to_index(int key, bool primary_only)
 {
@@ -2191,8 +2344,10 @@ int Menu::hotkey_to_index(int key, bool primary_only)
     for (int i = 0; i < final; ++i)
     {
         const int index = (i + first_entry) % final;
+        // an entry not yet made has only the one hotkey
         if (is_hotkey(index, key)
-            && (!primary_only || items[index]->hotkeys[0] == key))
+            && (!primary_only || !items[index]
+                || get_entry(index)->hotkeys[0] == key))
         {
             return index;
         }
@@ -2251,7 +2406,7 @@ bool Menu::examine_index(int i)
 {
     ASSERT(i >= 0 && i < static_cast<int>(items.size()));
     if (on_examine)
-        return on_examine(*items[i]);
+        return on_examine(*get_entry(i));
     return true;
 }
 
@@ -2571,7 +2726,7 @@ bool Menu::is_selectable(int item) const
     if (select_filter.empty())
         return true;
 
-    string text = items[item]->get_filter_text();
+    string text = get_entry(item)->get_filter_text();
     for (const text_pattern &pat : select_filter)
         if (pat.matches(text))
             return true;
@@ -2581,7 +2736,7 @@ bool Menu::is_selectable(int item) const
 
 void Menu::select_item_index(int idx, int qty)
 {
-    items[idx]->select(qty);
+    get_entry(idx)->select(qty);
     m_ui.menu->update_item(idx);
 #ifdef USE_TILE_WEB
     webtiles_update_item(idx);
@@ -2605,12 +2760,10 @@ void Menu::select_index(int index, int qty)
         {
             for (int i = 0, count = items.size(); i < count; ++i)
             {
-                if (items[i]->level != MEL_ITEM
-                    || items[i]->hotkeys.empty())
-                {
+                const int key = primary_hotkey(i);
+                if (!key)
                     continue;
-                }
-                if (is_hotkey(i, items[i]->hotkeys[0])
+                if (is_hotkey(i, key)
                     && (qty != MENU_SELECT_ALL || is_selectable(i)))
                 {
                     select_item_index(i, qty);
@@ -2618,20 +2771,18 @@ void Menu::select_index(int index, int qty)
             }
         }
     }
-    else if (items[si]->level == MEL_SUBTITLE && (flags & MF_MULTISELECT))
+    else if (get_entry(si)->level == MEL_SUBTITLE && (flags & MF_MULTISELECT))
     {
         for (int i = si + 1, count = items.size(); i < count; ++i)
         {
-            if (items[i]->level != MEL_ITEM
-                || items[i]->hotkeys.empty())
-            {
+            const int key = primary_hotkey(i);
+            if (!key)
                 continue;
-            }
-            if (is_hotkey(i, items[i]->hotkeys[0]))
+            if (is_hotkey(i, key))
                 select_item_index(i, qty);
         }
     }
-    else if (items[si]->level == MEL_ITEM
+    else if (get_entry(si)->level == MEL_ITEM
              && (flags & (MF_SINGLESELECT | MF_MULTISELECT)))
     {
         select_item_index(si, qty);
@@ -2643,8 +2794,8 @@ size_t Menu::item_count(bool include_headers) const
     size_t count = items.size();
     if (!include_headers)
     {
-        for (const auto &item : items)
-            if (item->level != MEL_ITEM)
+        for (int i = 0, size = items.size(); i < size; ++i)
+            if (get_entry(i)->level != MEL_ITEM)
             {
                 ASSERT(count > 0);
                 count--;
@@ -2656,8 +2807,9 @@ size_t Menu::item_count(bool include_headers) const
 int Menu::get_entry_index(const MenuEntry *e) const
 {
     int index = 0;
-    for (const auto &item : items)
+    for (int i = 0, size = items.size(); i < size; ++i)
     {
+        const MenuEntry *item = get_entry(i);
         if (item == e)
             return index;
 
@@ -3016,7 +3168,7 @@ bool Menu::page_down()
             set_hovered(items.size() - 1);
         else
             set_hovered(get_first_visible(true, col) + new_hover);
-        if (items[last_hovered]->level != MEL_ITEM)
+        if (get_entry(last_hovered)->level != MEL_ITEM)
             cycle_hover(true); // reverse so we don't overshoot
     }
 
@@ -3049,7 +3201,7 @@ bool Menu::page_up()
         if (is_set(MF_ARROWS_SELECT) && get_first_visible(true) + new_hover == last_hovered)
             new_hover = 0;
         set_hovered(get_first_visible(true) + new_hover);
-        if (items[last_hovered]->level != MEL_ITEM)
+        if (get_entry(last_hovered)->level != MEL_ITEM)
             cycle_hover(); // forward so we don't overshoot
     }
 
@@ -3119,7 +3271,7 @@ void Menu::cycle_hover(bool reverse, bool preserve_row, bool preserve_col)
                 continue;
         }
 
-        if (items[new_hover]->level == MEL_ITEM)
+        if (get_entry(new_hover)->level == MEL_ITEM)
         {
             found = true;
             break;
@@ -3159,10 +3311,10 @@ pair<int, int> Menu::get_header_block(int index) const
 {
     int first = index;
     int last = index;
-    while (first >= 1 && items[first - 1]->level != MEL_ITEM)
+    while (first >= 1 && get_entry(first - 1)->level != MEL_ITEM)
         first--;
     // if index is a header, scan forward to look for a non-headed
-    while (last + 1 < static_cast<int>(items.size()) && items[last]->level != MEL_ITEM)
+    while (last + 1 < static_cast<int>(items.size()) && get_entry(last)->level != MEL_ITEM)
         last++;
     return make_pair(first, last);
 }
@@ -3189,7 +3341,7 @@ bool Menu::cycle_headers(bool forward)
     int cur = next_block_from(start, forward, true);
     while (cur != start)
     {
-        if (items[cur]->level == MEL_SUBTITLE || items[cur]->level == MEL_TITLE)
+        if (get_entry(cur)->level == MEL_SUBTITLE || get_entry(cur)->level == MEL_TITLE)
         {
             if (!item_visible(cur) || !is_set(MF_ARROWS_SELECT))
                 set_scroll(cur);
@@ -3233,17 +3385,29 @@ void Menu::webtiles_write_menu(bool replace) const
     int start = 0;
     int end = start + count;
 
+    int first_entry = get_first_visible();
+
+    // Menus with an entry source only send the entries in view; the client
+    // asks for the rest as they scroll into view.
+    if (entry_source)
+    {
+        if (is_set(MF_START_AT_END))
+            start = max(0, count - WEBTILES_MENU_CHUNK);
+        else
+            start = min(first_entry, max(0, count - WEBTILES_MENU_CHUNK));
+        end = min(count, start + WEBTILES_MENU_CHUNK);
+    }
+
     tiles.json_write_int("total_items", count);
     tiles.json_write_int("chunk_start", start);
 
-    int first_entry = get_first_visible();
     if (first_entry != 0 && !is_set(MF_START_AT_END))
         tiles.json_write_int("jump_to", first_entry);
 
     tiles.json_open_array("items");
 
     for (int i = start; i < end; ++i)
-        webtiles_write_item(items[i]);
+        webtiles_write_item(get_entry(i));
 
     tiles.json_close_array();
 
@@ -3287,7 +3451,7 @@ void Menu::webtiles_handle_item_request(int start, int end)
     tiles.json_open_array("items");
 
     for (int i = start; i <= end; ++i)
-        webtiles_write_item(items[i]);
+        webtiles_write_item(get_entry(i));
 
     tiles.json_close_array();
 
@@ -3391,7 +3555,8 @@ void Menu::webtiles_write_item(const MenuEntry* me) const
         tiles.json_write_string("text", me->get_text());
     else
     {
-        tiles.json_write_string("text", "");
+        // Not made yet, so leave whatever the client has.
+        tiles.json_write_bool("placeholder", true);
         tiles.json_close_object();
         return;
     }
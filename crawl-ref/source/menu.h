@@ -334,6 +334,9 @@ public:
     {
         add_entry(entry.release());
     }
+    void set_entry_source(int count, function<MenuEntry*(int)> make_entry,
+                          function<int(int)> entry_hotkey = nullptr);
+    MenuEntry *get_entry(int index) const;
     void get_selected(vector<MenuEntry*> *sel) const;
 
     void set_select_filter(vector<text_pattern> filter)
@@ -411,8 +414,10 @@ protected:
     formatted_string more;
     bool m_keyhelp_more;
 
-    vector<MenuEntry*>  items;
+    vector<MenuEntry*>  items; // nullptr for entries not yet made
     vector<MenuEntry*>  sel;
+    function<MenuEntry*(int)> entry_source;
+    function<int(int)> entry_source_hotkey; // hotkey of an entry not yet made
     vector<text_pattern> select_filter;
 
     // Class that is queried to colour menu entries.
@@ -480,6 +485,7 @@ protected:
     bool process_selection();
 
     bool is_hotkey(int index, int key);
+    int primary_hotkey(int index) const;
     virtual bool is_selectable(int index) const;
 
     virtual string help_key() const { return ""; }
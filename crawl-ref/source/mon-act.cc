@@ -67,6 +67,7 @@
 #include "throw.h"
 #include "timed-effects.h"
 #include "traps.h"
+#include "turn-profile.h"
 #include "viewchar.h"
 #include "view.h"
 
@@ -1701,6 +1702,7 @@ static bool _mons_take_special_action(monster &mons, int old_energy)
 void handle_monster_move(monster* mons)
 {
     ASSERT(mons); // XXX: change to monster &mons
+    TURN_PROFILE_COUNT(monster_moves, 1);
     const monsterentry* entry = get_monster_data(mons->type);
     if (!entry)
         return;
@@ -2412,6 +2414,8 @@ static void _display_just_seen()
  */
 void handle_monsters(bool with_noise)
 {
+    TURN_PROFILE_SCOPE(monsters);
+
     for (monster_iterator mi; mi; ++mi)
     {
         _pre_monster_move(**mi);
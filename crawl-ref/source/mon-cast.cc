@@ -859,17 +859,36 @@ static const map<spell_type, mons_spell_logic> marionette_spell_to_logic {
     } },
 };
 
+/// What monster casting needs to know about a spell on every cast attempt,
+/// looked up from the spell data once by init_mons_spells().
+struct mons_spell_info
+{
+    spell_flags flags;
+    bool harms_area;
+    bool harms_target;
+    bool summoning;
+    bool summons_capped;
+    const mons_spell_logic* logic;
+    const mons_spell_logic* marionette_logic;
+};
+
+static mons_spell_info _mon_spell_info[NUM_SPELLS];
+
+static const mons_spell_info &_spell_info(spell_type spell)
+{
+    ASSERT_RANGE(spell, 0, NUM_SPELLS);
+    return _mon_spell_info[spell];
+}
+
 static const mons_spell_logic* _get_spell_logic(const monster& caster, spell_type spell)
 {
+    const mons_spell_info &info = _spell_info(spell);
+
     // Use marionette overrides when appropriate
-    if (caster.attitude == ATT_MARIONETTE)
-    {
-        const mons_spell_logic* logic = map_find(marionette_spell_to_logic, spell);
-        if (logic)
-            return logic;
-    }
+    if (caster.attitude == ATT_MARIONETTE && info.marionette_logic)
+        return info.marionette_logic;
 
-    return map_find(spell_to_logic, spell);
+    return info.logic;
 }
 
 /// Create the appropriate casting logic for a simple conjuration.
@@ -1302,9 +1321,20 @@ void init_mons_spells()
 
         _valid_mon_spells[i] = false;
 
+        mons_spell_info &info = _mon_spell_info[i];
+        info = mons_spell_info();
+        info.logic = map_find(spell_to_logic, spell);
+        info.marionette_logic = map_find(marionette_spell_to_logic, spell);
+
         if (!is_valid_spell(spell))
             continue;
 
+        info.flags = get_spell_flags(spell);
+        info.harms_area = spell_harms_area(spell);
+        info.harms_target = spell_harms_target(spell);
+        info.summoning = spell_typematch(spell, spschool::summoning);
+        info.summons_capped = summons_are_capped(spell);
+
         if (setup_mons_cast(&fake_mon, pbolt, spell, false, true))
             _valid_mon_spells[i] = true;
     }
@@ -1514,7 +1544,7 @@ static void _whack(const actor &caster, actor &target)
  */
 static int _mons_power_hd_factor(spell_type spell)
 {
-    const mons_spell_logic* logic = map_find(spell_to_logic, spell);
+    const mons_spell_logic* logic = _spell_info(spell).logic;
     if (logic && logic->power_hd_factor)
         return logic->power_hd_factor;
 
@@ -2605,12 +2635,17 @@ static void _set_door(set<coord_def> door, dungeon_feature_type feat)
 static int _tension_door_closed(set<coord_def> door,
                                 dungeon_feature_type old_feat)
 {
-    // this unwind is a bit heavy, but because out-of-los clouds dissipate
-    // instantly, they can be wiped out by these door tests.
-    unwind_var<map<coord_def, cloud_struct>> cloud_state(env.cloud);
+    // because out-of-los clouds dissipate instantly, they can be wiped out
+    // by these door tests, so put back the ones there were.
+    vector<cloud_struct> clouds;
+    for (const coord_def &pos : env.cloud.positions())
+        clouds.push_back(*env.cloud.find(pos));
     _set_door(door, DNGN_CLOSED_DOOR);
     const int new_tension = get_tension(GOD_NO_GOD);
     _set_door(door, old_feat);
+    env.cloud.clear();
+    for (const cloud_struct &cloud : clouds)
+        env.cloud.insert(cloud.pos, cloud);
     return new_tension;
 }
 
@@ -4252,7 +4287,7 @@ static bool _should_cast_spell(const monster &mons, spell_type spell,
                                bolt &beem, bool ignore_good_idea)
 {
     // beam-type spells requiring tracers
-    if (get_spell_flags(spell) & spflag::needs_tracer)
+    if (_spell_info(spell).flags & spflag::needs_tracer)
     {
         const bool explode = spell_is_direct_explosion(spell);
         fire_tracer(&mons, beem, explode);
@@ -4699,7 +4734,7 @@ bool try_mons_cast(monster& mons, spell_type spell)
 
 bool spell_has_marionette_override(spell_type spell)
 {
-    return map_find(marionette_spell_to_logic, spell) != nullptr;
+    return _spell_info(spell).marionette_logic != nullptr;
 }
 
 static int _monster_abjure_target(monster* target, int pow, bool actual)
@@ -8299,12 +8334,13 @@ ai_action::goodness monster_spell_goodness(monster* mon, spell_type spell)
 {
     actor *foe = mon->get_foe();
     const bool friendly = mon->friendly();
+    const mons_spell_info &info = _spell_info(spell);
 
-    if (!foe && (get_spell_flags(spell) & spflag::targeting_mask))
+    if (!foe && (info.flags & spflag::targeting_mask))
         return ai_action::impossible();
 
     // Keep friendly summoners from spamming summons constantly.
-    if (friendly && !foe && spell_typematch(spell, spschool::summoning))
+    if (friendly && !foe && info.summoning)
         return ai_action::bad();
 
     // Don't use abilities while rolling.
@@ -8317,16 +8353,16 @@ ai_action::goodness monster_spell_goodness(monster* mon, spell_type spell)
 
     if (!mon->wont_attack())
     {
-        if (spell_harms_area(spell) && env.sanctuary_time > 0)
+        if (info.harms_area && env.sanctuary_time > 0)
             return ai_action::impossible();
 
-        if (spell_harms_target(spell) && is_sanctuary(mon->target))
+        if (info.harms_target && is_sanctuary(mon->target))
             return ai_action::impossible();
     }
 
     // Don't bother casting a summon spell if we're already at its cap
     // (Marionettes pass their summons onto the player, so count for them instead)
-    if (summons_are_capped(spell))
+    if (info.summons_capped)
     {
         if (mon->attitude == ATT_MARIONETTE)
         {
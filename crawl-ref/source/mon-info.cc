@@ -1226,6 +1226,25 @@ string monster_info::full_name(description_level_type desc) const
         return common_name(desc);
 }
 
+/**
+ * What the webtiles map shows of this monster. Worked out once, then kept:
+ * a monster_info isn't changed once it has been put in the map knowledge.
+ */
+const monster_snapshot &monster_info::snapshot() const
+{
+    if (!has_snapshot)
+    {
+        cached_snapshot.type = type;
+        cached_snapshot.base_type = base_type;
+        cached_snapshot.attitude = attitude;
+        cached_snapshot.threat = threat;
+        cached_snapshot.name = full_name();
+        cached_snapshot.plural = pluralised_name();
+        has_snapshot = true;
+    }
+    return cached_snapshot;
+}
+
 // Needed because gcc 4.3 sort does not like comparison functions that take
 // more than 2 arguments.
 bool monster_info::less_than_wrapper(const monster_info& m1,
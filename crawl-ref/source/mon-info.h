@@ -289,6 +289,18 @@ struct monster_info_base
     uint32_t client_id;
 };
 
+// The parts of a monster_info that the webtiles map shows, so that a
+// redraw can tell cheaply whether they have changed.
+struct monster_snapshot
+{
+    monster_type type;
+    monster_type base_type;
+    mon_attitude_type attitude;
+    mon_threat_level_type threat;
+    string name;            ///< full_name()
+    string plural;          ///< pluralised_name()
+};
+
 // Monster info used by the pane; precomputes some data
 // to help with sorting and rendering.
 struct monster_info : public monster_info_base
@@ -372,6 +384,8 @@ struct monster_info : public monster_info_base
     string proper_name(description_level_type desc = DESC_PLAIN) const;
     string full_name(description_level_type desc = DESC_PLAIN) const;
 
+    const monster_snapshot &snapshot() const;
+
     vector<string> attributes() const;
 
     const char *pronoun(pronoun_type variant) const;
@@ -464,6 +478,13 @@ protected:
     string _core_name() const;
     string _base_name() const;
     string _apply_adjusted_description(description_level_type desc, const string& s) const;
+
+private:
+    // Made by the first snapshot() call. Copies don't keep it, since they
+    // may go on to be changed; an unchanged monster_info is shared instead
+    // (see map_cell).
+    mutable monster_snapshot cached_snapshot;
+    mutable bool has_snapshot = false;
 };
 
 // Colour should be between -1 and 15 inclusive!
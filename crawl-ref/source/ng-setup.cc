@@ -167,6 +167,7 @@ item_def* newgame_make_item(object_class_type base,
         && you.equip[get_item_slot(item)] == -1)
     {
         you.equip[get_item_slot(item)] = slot;
+        you.equipment_changed();
     }
     else if (item.base_type == OBJ_WEAPONS
              && you.species == SP_COGLIN
@@ -176,6 +177,7 @@ item_def* newgame_make_item(object_class_type base,
              && you.hands_reqd(*you.weapon()) == HANDS_ONE)
     {
         you.equip[EQ_OFFHAND] = slot;
+        you.equipment_changed();
     }
 
     if (item.base_type == OBJ_MISSILES)
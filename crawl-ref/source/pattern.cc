@@ -20,46 +20,70 @@
 ////////////////////////////////////////////////////////////////////
 // Perl Compatible Regular Expressions
 
-static void *_compile_pattern(const char *pattern, bool icase)
+struct compiled_pattern
+{
+    pcre *re;
+    pcre_extra *extra;
+
+    ~compiled_pattern()
+    {
+#ifdef PCRE_STUDY_JIT_COMPILE
+        pcre_free_study(extra);
+#else
+        pcre_free(extra);
+#endif
+        pcre_free(re);
+    }
+};
+
+static compiled_pattern *_compile_pattern(const char *pattern, bool icase)
 {
     const char *error;
     int erroffset;
     int flags = icase ? PCRE_CASELESS : 0;
-    return pcre_compile(pattern,
-                        flags,
-                        &error,
-                        &erroffset,
-                        nullptr);
-}
+    pcre *re = pcre_compile(pattern,
+                            flags,
+                            &error,
+                            &erroffset,
+                            nullptr);
+    if (!re)
+        return nullptr;
 
-static void _free_compiled_pattern(void *cp)
-{
-    if (cp)
-        pcre_free(cp);
+    // Patterns are matched many times each (autopickup, message filters),
+    // so JIT them where the library can. Failing that, matching without
+    // the study data still works.
+#ifdef PCRE_STUDY_JIT_COMPILE
+    pcre_extra *extra = pcre_study(re, PCRE_STUDY_JIT_COMPILE, &error);
+#else
+    pcre_extra *extra = pcre_study(re, 0, &error);
+#endif
+    return new compiled_pattern { re, extra };
 }
 
-static bool _pattern_match(void *compiled_pattern, const char *text, int length)
+static bool _pattern_match(const compiled_pattern &cp, const char *text,
+                           int length)
 {
     int ovector[42];
-    int pcre_rc = pcre_exec(static_cast<pcre *>(compiled_pattern),
-                            nullptr,
+    int pcre_rc = pcre_exec(cp.re, cp.extra,
                             text, length, 0, 0,
                             ovector, sizeof(ovector) / sizeof(*ovector));
     return pcre_rc >= 0;
 }
 
-static pattern_match _pattern_match_location(void *compiled_pattern,
+static pattern_match _pattern_match_location(const compiled_pattern &cp,
                                              const char *text, int length)
 {
     int ovector[42];
-    int pcre_rc = pcre_exec(static_cast<pcre *>(compiled_pattern),
-                            nullptr,
+    int pcre_rc = pcre_exec(cp.re, cp.extra,
                             text, length, 0, 0,
                             ovector, sizeof(ovector) / sizeof(*ovector));
     if (pcre_rc >= 0)
-        return pattern_match::succeeded(string(text), ovector[0], ovector[1]);
+    {
+        return pattern_match::succeeded(string(text, length),
+                                        ovector[0], ovector[1]);
+    }
     else
-        return pattern_match::failed(string(text));
+        return pattern_match::failed(string(text, length));
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -67,11 +91,20 @@ static pattern_match _pattern_match_location(void *compiled_pattern,
 ////////////////////////////////////////////////////////////////////
 // POSIX regular expressions
 
-static void *_compile_pattern(const char *pattern, bool icase)
+struct compiled_pattern
+{
+    regex_t *re;
+
+    ~compiled_pattern()
+    {
+        regfree(re);
+        delete re;
+    }
+};
+
+static compiled_pattern *_compile_pattern(const char *pattern, bool icase)
 {
     regex_t *re = new regex_t;
-    if (!re)
-        return nullptr;
 
     int flags = REG_EXTENDED;
     if (icase)
@@ -83,41 +116,110 @@ static void *_compile_pattern(const char *pattern, bool icase)
         delete re;
         return nullptr;
     }
-    return re;
+    return new compiled_pattern { re };
 }
 
-static void _free_compiled_pattern(void *cp)
+// Match the first length bytes of text. Without REG_STARTEND, text must be
+// NUL-terminated there.
+static bool _regexec(const compiled_pattern &cp, const char *text, int length,
+                     regmatch_t &match)
 {
-    if (cp)
-    {
-        regex_t *re = static_cast<regex_t *>(cp);
-        regfree(re);
-        delete re;
-    }
+#ifdef REG_STARTEND
+    match.rm_so = 0;
+    match.rm_eo = length;
+    return !regexec(cp.re, text, 1, &match, REG_STARTEND);
+#else
+    UNUSED(length);
+    return !regexec(cp.re, text, 1, &match, 0);
+#endif
 }
 
-static bool _pattern_match(void *compiled_pattern, const char *text, int length)
+static bool _pattern_match(const compiled_pattern &cp, const char *text,
+                           int length)
 {
-    UNUSED(length);
-    regex_t *re = static_cast<regex_t *>(compiled_pattern);
-    return !regexec(re, text, 0, nullptr, 0);
+    regmatch_t match;
+    return _regexec(cp, text, length, match);
 }
 
-static pattern_match _pattern_match_location(void *compiled_pattern,
+static pattern_match _pattern_match_location(const compiled_pattern &cp,
                                              const char *text, int length)
 {
-    UNUSED(length);
     regmatch_t match;
-    regex_t *re = static_cast<regex_t *>(compiled_pattern);
-    if (!regexec(re, text, 1, &match, 0))
-        return pattern_match::succeeded(string(text), match.rm_so, match.rm_eo);
+    if (_regexec(cp, text, length, match))
+    {
+        return pattern_match::succeeded(string(text, length),
+                                        match.rm_so, match.rm_eo);
+    }
     else
-        return pattern_match::failed(string(text));
+        return pattern_match::failed(string(text, length));
 }
 
 ////////////////////////////////////////////////////////////////////
 #endif
 
+////////////////////////////////////////////////////////////////////
+// The compiled pattern cache
+//
+// Options, menus and searches make many text_patterns for the same few
+// patterns, so each pattern is compiled once and shared while anything
+// still uses it. Only entries that nothing uses are dropped, and only once
+// the cache has doubled in size since it was last cleaned, so the cost
+// stays small however many patterns come and go.
+
+typedef map<pair<string, bool>, weak_ptr<const compiled_pattern>>
+    pattern_cache;
+
+static pattern_cache &_pattern_cache()
+{
+    static pattern_cache cache;
+    return cache;
+}
+
+static void _clean_pattern_cache(pattern_cache &cache)
+{
+    static size_t limit = 64;
+    if (cache.size() < limit)
+        return;
+
+    for (auto it = cache.begin(); it != cache.end();)
+    {
+        if (it->second.expired())
+            it = cache.erase(it);
+        else
+            ++it;
+    }
+    limit = max<size_t>(64, cache.size() * 2);
+}
+
+static shared_ptr<const compiled_pattern> _cached_pattern(const string &pattern,
+                                                          bool icase)
+{
+    pattern_cache &cache = _pattern_cache();
+    const auto key = make_pair(pattern, icase);
+    auto it = cache.find(key);
+    if (it != cache.end())
+    {
+        if (auto cp = it->second.lock())
+            return cp;
+    }
+
+    shared_ptr<const compiled_pattern> cp(_compile_pattern(pattern.c_str(),
+                                                           icase));
+    // Don't remember failures: the text_pattern marks itself invalid, and
+    // its copies carry that along.
+    if (!cp)
+        return cp;
+
+    if (it != cache.end())
+        it->second = cp;
+    else
+    {
+        _clean_pattern_cache(cache);
+        cache.emplace(key, cp);
+    }
+    return cp;
+}
+
 string pattern_match::annotate_string(const string &color) const
 {
     string ret(text);
@@ -131,21 +233,13 @@ string pattern_match::annotate_string(const string &color) const
     return ret;
 }
 
-text_pattern::~text_pattern()
-{
-    if (compiled_pattern)
-        _free_compiled_pattern(compiled_pattern);
-}
-
 const text_pattern &text_pattern::operator= (const text_pattern &tp)
 {
     if (this == &tp)
         return tp;
 
-    if (compiled_pattern)
-        _free_compiled_pattern(compiled_pattern);
     pattern = tp.pattern;
-    compiled_pattern = nullptr;
+    compiled = tp.compiled;
     isvalid      = tp.isvalid;
     ignore_case  = tp.ignore_case;
     return *this;
@@ -156,10 +250,8 @@ const text_pattern &text_pattern::operator= (const string &spattern)
     if (pattern == spattern)
         return *this;
 
-    if (compiled_pattern)
-        _free_compiled_pattern(compiled_pattern);
     pattern = spattern;
-    compiled_pattern = nullptr;
+    compiled.reset();
     isvalid = true;
     // We don't change ignore_case
     return *this;
@@ -176,21 +268,21 @@ bool text_pattern::operator== (const text_pattern &tp) const
 bool text_pattern::compile() const
 {
     return !empty()?
-        !!(compiled_pattern = _compile_pattern(pattern.c_str(), ignore_case))
+        !!(compiled = _cached_pattern(pattern, ignore_case))
       : false;
 }
 
 bool text_pattern::matches(const char *s, int length) const
 {
-    return valid() && _pattern_match(compiled_pattern, s, length);
+    return valid() && _pattern_match(*compiled, s, length);
 }
 
 pattern_match text_pattern::match_location(const char *s, int length) const
 {
     if (valid())
-        return _pattern_match_location(compiled_pattern, s, length);
+        return _pattern_match_location(*compiled, s, length);
     else
-        return pattern_match::failed(string(s));
+        return pattern_match::failed(string(s, length));
 }
 
 const plaintext_pattern &plaintext_pattern::operator= (const string &spattern)
@@ -49,31 +49,28 @@ public:
     virtual const string &tostring() const = 0;
 };
 
+// A compiled regex; shared by every text_pattern with the same pattern and
+// case sensitivity.
+struct compiled_pattern;
+
 class text_pattern : public base_pattern
 {
 public:
     text_pattern(const string &s, bool icase = false)
-        : pattern(s), compiled_pattern(nullptr),
+        : pattern(s), compiled(),
           isvalid(true), ignore_case(icase)
     {
     }
 
     text_pattern()
-        : pattern(), compiled_pattern(nullptr),
+        : pattern(), compiled(),
          isvalid(false), ignore_case(false)
     {
     }
 
-    text_pattern(const text_pattern &tp)
-        : base_pattern(tp),
-          pattern(tp.pattern),
-          compiled_pattern(nullptr),
-          isvalid(tp.isvalid),
-          ignore_case(tp.ignore_case)
-    {
-    }
+    // Copies share the compiled regex, if there is one yet.
+    text_pattern(const text_pattern &tp) = default;
 
-    ~text_pattern();
     const text_pattern &operator= (const text_pattern &tp);
     const text_pattern &operator= (const string &spattern);
     bool operator== (const text_pattern &tp) const;
@@ -84,7 +81,7 @@ public:
     bool valid() const override
     {
         return isvalid
-            && (compiled_pattern || (isvalid = compile()));
+            && (compiled || (isvalid = compile()));
     }
 
     bool matches(const char *s, int length) const;
@@ -118,7 +115,7 @@ public:
 
 private:
     string pattern;
-    mutable void *compiled_pattern;
+    mutable shared_ptr<const compiled_pattern> compiled;
     mutable bool isvalid;
     bool ignore_case;
 };
@@ -1103,15 +1103,8 @@ int player::wearing_ego(equipment_type slot, int special) const
         break;
 
     case EQ_ALL_ARMOUR:
-        // Check all armour slots:
-        for (int i = EQ_MIN_ARMOUR; i <= EQ_MAX_ARMOUR; i++)
-        {
-            if ((item = slot_item(static_cast<equipment_type>(i)))
-                && get_armour_ego_type(*item) == special)
-            {
-                ret++;
-            }
-        }
+        ASSERT_RANGE(special, 0, NUM_SPECIAL_ARMOURS);
+        ret = equip_totals().armour_egos[special];
         break;
 
     default:
@@ -1395,27 +1388,7 @@ int player_res_fire(bool allow_random, bool temp, bool items)
 
     if (items)
     {
-        // rings of fire resistance/fire
-        rf += you.wearing(EQ_RINGS, RING_PROTECTION_FROM_FIRE);
-        rf += you.wearing(EQ_RINGS, RING_FIRE);
-
-        // rings of ice
-        rf -= you.wearing(EQ_RINGS, RING_ICE);
-
-        // Staves
-        rf += you.wearing(EQ_STAFF, STAFF_FIRE);
-
-        // body armour:
-        const item_def *body_armour = you.slot_item(EQ_BODY_ARMOUR);
-        if (body_armour)
-            rf += armour_type_prop(body_armour->sub_type, ARMF_RES_FIRE);
-
-        // ego armours
-        rf += you.wearing_ego(EQ_ALL_ARMOUR, SPARM_FIRE_RESISTANCE);
-        rf += you.wearing_ego(EQ_ALL_ARMOUR, SPARM_RESISTANCE);
-
-        // randart weapons:
-        rf += you.scan_artefacts(ARTP_FIRE);
+        rf += you.equip_totals().res_fire;
 
         // dragonskin cloak: 0.5 to draconic resistances
         if (allow_random && player_equip_unrand(UNRAND_DRAGONSKIN)
@@ -1501,27 +1474,7 @@ int player_res_cold(bool allow_random, bool temp, bool items)
 
     if (items)
     {
-        // rings of cold resistance/ice
-        rc += you.wearing(EQ_RINGS, RING_PROTECTION_FROM_COLD);
-        rc += you.wearing(EQ_RINGS, RING_ICE);
-
-        // rings of fire
-        rc -= you.wearing(EQ_RINGS, RING_FIRE);
-
-        // Staves
-        rc += you.wearing(EQ_STAFF, STAFF_COLD);
-
-        // body armour:
-        const item_def *body_armour = you.slot_item(EQ_BODY_ARMOUR);
-        if (body_armour)
-            rc += armour_type_prop(body_armour->sub_type, ARMF_RES_COLD);
-
-        // ego armours
-        rc += you.wearing_ego(EQ_ALL_ARMOUR, SPARM_COLD_RESISTANCE);
-        rc += you.wearing_ego(EQ_ALL_ARMOUR, SPARM_RESISTANCE);
-
-        // randart weapons:
-        rc += you.scan_artefacts(ARTP_COLD);
+        rc += you.equip_totals().res_cold;
 
         // dragonskin cloak: 0.5 to draconic resistances
         if (allow_random && player_equip_unrand(UNRAND_DRAGONSKIN)
@@ -1591,16 +1544,7 @@ int player_res_electricity(bool allow_random, bool temp, bool items)
 
     if (items)
     {
-        // staff
-        re += you.wearing(EQ_STAFF, STAFF_AIR);
-
-        // body armour:
-        const item_def *body_armour = you.slot_item(EQ_BODY_ARMOUR);
-        if (body_armour)
-            re += armour_type_prop(body_armour->sub_type, ARMF_RES_ELEC);
-
-        // randart weapons:
-        re += you.scan_artefacts(ARTP_ELECTRICITY);
+        re += you.equip_totals().res_elec;
 
         // dragonskin cloak: 0.5 to draconic resistances
         if (allow_random && player_equip_unrand(UNRAND_DRAGONSKIN)
@@ -1658,22 +1602,7 @@ int player_res_poison(bool allow_random, bool temp, bool items, bool forms)
 
     if (items)
     {
-        // rings of poison resistance
-        rp += you.wearing(EQ_RINGS, RING_POISON_RESISTANCE);
-
-        // Staves
-        rp += you.wearing(EQ_STAFF, STAFF_ALCHEMY);
-
-        // ego armour:
-        rp += you.wearing_ego(EQ_ALL_ARMOUR, SPARM_POISON_RESISTANCE);
-
-        // body armour:
-        const item_def *body_armour = you.slot_item(EQ_BODY_ARMOUR);
-        if (body_armour)
-            rp += armour_type_prop(body_armour->sub_type, ARMF_RES_POISON);
-
-        // rPois+ artefacts
-        rp += you.scan_artefacts(ARTP_POISON);
+        rp += you.equip_totals().res_pois;
 
         // dragonskin cloak: 0.5 to draconic resistances
         if (allow_random && player_equip_unrand(UNRAND_DRAGONSKIN)
@@ -3705,12 +3634,14 @@ int slaying_bonus(bool throwing, bool random)
 }
 
 // Checks each equip slot for a randart, and adds up all of those with
-// a given property. Slow if any randarts are worn, so avoid where
-// possible. If `matches' is non-nullptr, items with nonzero property are
-// pushed onto *matches.
+// a given property. If `matches' is non-nullptr, items with nonzero property
+// are pushed onto *matches; otherwise the cached totals are used.
 int player::scan_artefacts(artefact_prop_type which_property,
                            vector<const item_def *> *matches) const
 {
+    if (!matches)
+        return equip_totals().artp[which_property];
+
     int retval = 0;
 
     for (int i = EQ_FIRST_EQUIP; i < NUM_EQUIP; ++i)
@@ -3733,7 +3664,7 @@ int player::scan_artefacts(artefact_prop_type which_property,
 
         retval += val;
 
-        if (matches && val)
+        if (val)
             matches->push_back(&item);
     }
 
@@ -3741,13 +3672,142 @@ int player::scan_artefacts(artefact_prop_type which_property,
     {
         const int val = artefact_property(you.active_talisman, which_property);
         retval += val;
-        if (matches && val)
+        if (val)
             matches->push_back(&you.active_talisman);
     }
 
     return retval;
 }
 
+static void _add_artefact_totals(equipment_totals &totals,
+                                 const item_def &item)
+{
+    artefact_properties_t proprt;
+    artefact_properties(item, proprt);
+    for (int i = 0; i < ARTP_NUM_PROPERTIES; ++i)
+        totals.artp[i] += proprt[i];
+}
+
+static void _compute_equip_totals(const player &p, equipment_totals &totals)
+{
+    totals.artp.init(0);
+    totals.armour_egos.init(0);
+
+    for (int i = EQ_FIRST_EQUIP; i < NUM_EQUIP; ++i)
+    {
+        if (p.melded[i] || p.equip[i] == -1)
+            continue;
+
+        const item_def &item = p.inv[p.equip[i]];
+
+        // Only weapons give their effects when in our hands.
+        if (i == EQ_WEAPON && !is_weapon(item))
+            continue;
+
+        if (is_artefact(item))
+            _add_artefact_totals(totals, item);
+
+        if (i >= EQ_MIN_ARMOUR && i <= EQ_MAX_ARMOUR)
+            ++totals.armour_egos[get_armour_ego_type(item)];
+    }
+
+    if (p.active_talisman.defined() && is_artefact(p.active_talisman))
+        _add_artefact_totals(totals, p.active_talisman);
+
+    const item_def *body_armour = p.slot_item(EQ_BODY_ARMOUR);
+    const auto body_prop = [body_armour](armour_flag flag)
+    {
+        return body_armour ? armour_type_prop(body_armour->sub_type, flag) : 0;
+    };
+
+    // rings of fire resistance/fire, rings of ice, staves, body armour,
+    // ego armours and artefacts
+    totals.res_fire = p.wearing(EQ_RINGS, RING_PROTECTION_FROM_FIRE)
+                      + p.wearing(EQ_RINGS, RING_FIRE)
+                      - p.wearing(EQ_RINGS, RING_ICE)
+                      + p.wearing(EQ_STAFF, STAFF_FIRE)
+                      + body_prop(ARMF_RES_FIRE)
+                      + totals.armour_egos[SPARM_FIRE_RESISTANCE]
+                      + totals.armour_egos[SPARM_RESISTANCE]
+                      + totals.artp[ARTP_FIRE];
+
+    totals.res_cold = p.wearing(EQ_RINGS, RING_PROTECTION_FROM_COLD)
+                      + p.wearing(EQ_RINGS, RING_ICE)
+                      - p.wearing(EQ_RINGS, RING_FIRE)
+                      + p.wearing(EQ_STAFF, STAFF_COLD)
+                      + body_prop(ARMF_RES_COLD)
+                      + totals.armour_egos[SPARM_COLD_RESISTANCE]
+                      + totals.armour_egos[SPARM_RESISTANCE]
+                      + totals.artp[ARTP_COLD];
+
+    totals.res_elec = p.wearing(EQ_STAFF, STAFF_AIR)
+                      + body_prop(ARMF_RES_ELEC)
+                      + totals.artp[ARTP_ELECTRICITY];
+
+    totals.res_pois = p.wearing(EQ_RINGS, RING_POISON_RESISTANCE)
+                      + p.wearing(EQ_STAFF, STAFF_ALCHEMY)
+                      + totals.armour_egos[SPARM_POISON_RESISTANCE]
+                      + body_prop(ARMF_RES_POISON)
+                      + totals.artp[ARTP_POISON];
+}
+
+static void _check_equip_totals(const equipment_totals &cached,
+                                const equipment_totals &fresh)
+{
+    for (int i = 0; i < ARTP_NUM_PROPERTIES; ++i)
+    {
+        ASSERTM(cached.artp[i] == fresh.artp[i],
+                "stale equipment cache: %s is %d, should be %d",
+                artp_name(static_cast<artefact_prop_type>(i)),
+                cached.artp[i], fresh.artp[i]);
+    }
+    for (int i = 0; i < NUM_SPECIAL_ARMOURS; ++i)
+    {
+        ASSERTM(cached.armour_egos[i] == fresh.armour_egos[i],
+                "stale equipment cache: armour ego %d is %d, should be %d",
+                i, cached.armour_egos[i], fresh.armour_egos[i]);
+    }
+    ASSERTM(cached.res_fire == fresh.res_fire
+            && cached.res_cold == fresh.res_cold
+            && cached.res_elec == fresh.res_elec
+            && cached.res_pois == fresh.res_pois,
+            "stale equipment cache: resists %d/%d/%d/%d, should be %d/%d/%d/%d",
+            cached.res_fire, cached.res_cold, cached.res_elec, cached.res_pois,
+            fresh.res_fire, fresh.res_cold, fresh.res_elec, fresh.res_pois);
+}
+
+/**
+ * The totals of everything the player's equipment grants, recomputed only
+ * if equipment_changed() has been called since the last time. With
+ * crawl_state.check_equip_cache set, the cached totals are instead checked
+ * against a fresh computation on every call.
+ */
+const equipment_totals &player::equip_totals() const
+{
+    if (cached_equip_version != equip_version)
+    {
+        _compute_equip_totals(*this, cached_equip);
+        cached_equip_version = equip_version;
+    }
+    else if (crawl_state.check_equip_cache)
+    {
+        equipment_totals fresh;
+        _compute_equip_totals(*this, fresh);
+        _check_equip_totals(cached_equip, fresh);
+    }
+    return cached_equip;
+}
+
+/**
+ * Invalidate the cached equipment totals. Call this after anything that
+ * changes what is equipped, what is melded, or the properties or ego of an
+ * equipped item.
+ */
+void player::equipment_changed()
+{
+    ++equip_version;
+}
+
 bool player::using_talisman(const item_def &talisman) const
 {
     if (!active_talisman.defined())
@@ -5450,6 +5510,8 @@ player::player()
     unrand_reacts.reset();
     activated.reset();
     last_unequip = -1;
+    equip_version        = 1;
+    cached_equip_version = 0;
 
     symbol          = MONS_PLAYER;
     form            = transformation::none;
@@ -6681,6 +6743,7 @@ void player::ac_ev_sh_with_specific_item(int scale, const item_def& new_item,
         you.inv[ENDOFPACK] = new_item;
         you.equip[slot] = ENDOFPACK;
     }
+    you.equipment_changed();
 
     // Now, simply calculate AC/EV/SH without temporary boosts.
     *ac = base_ac(scale);
@@ -6690,6 +6753,7 @@ void player::ac_ev_sh_with_specific_item(int scale, const item_def& new_item,
     // Restore old item and clear out any item copies, just in case.
     you.equip[slot] = old_item;
     you.inv[ENDOFPACK].clear();
+    you.equipment_changed();
 }
 
 void player::ac_ev_sh_without_specific_item(int scale,
@@ -6704,10 +6768,12 @@ void player::ac_ev_sh_without_specific_item(int scale,
 
     // Briefly remove item, calculate EV/SH, then put it back on
     you.equip[slot] = -1;
+    you.equipment_changed();
     *ac = base_ac(scale);
     *ev = evasion_scaled(scale, true);
     *sh = player_displayed_shield_class(scale, true);
     you.equip[slot] = item_to_remove.link;
+    you.equipment_changed();
 }
 
 bool player::heal(int amount)
@@ -111,6 +111,22 @@ enum training_status
 extern player you;
 
 typedef FixedVector<int, NUM_DURATIONS> durations_t;
+
+// Totals of the properties granted by the player's worn equipment. Walking
+// every equipped item and its artefact properties is slow, and monster spell
+// and beam code ask for these many times a turn, so player::equip_totals()
+// keeps them cached until player::equipment_changed() is called.
+struct equipment_totals
+{
+    FixedVector<int, ARTP_NUM_PROPERTIES> artp;
+    FixedVector<int, NUM_SPECIAL_ARMOURS> armour_egos;
+    // Resistances from items, not counting the dragonskin cloak's coinflip.
+    int res_fire;
+    int res_cold;
+    int res_elec;
+    int res_pois;
+};
+
 class player : public actor
 {
 public:
@@ -417,6 +433,11 @@ public:
     map<int,int> last_pickup;
     int last_unequip;
 
+    // See equip_totals().
+    unsigned int equip_version;
+    mutable unsigned int cached_equip_version;
+    mutable equipment_totals cached_equip;
+
     // ---------------------------
     // Volatile (same-turn) state:
     // ---------------------------
@@ -672,6 +693,8 @@ public:
         override;
     int scan_artefacts(artefact_prop_type which_property,
                        vector<const item_def *> *matches = nullptr) const override;
+    const equipment_totals &equip_totals() const;
+    void equipment_changed();
 
     int infusion_amount() const;
 
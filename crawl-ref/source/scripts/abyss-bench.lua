@@ -0,0 +1,20 @@
+-- Times abyssal shifts, which resample the procedural abyss layouts over
+-- most of the level each time.
+-- Usage: crawl -script abyss-bench [shifts]
+
+local args = script.simple_args()
+local shifts = tonumber(args[1]) or 200
+
+debug.disable("death")
+debug.reset_rng(1)
+test.regenerate_level("Abyss")
+
+local start = crawl.millis()
+for i = 1, shifts do
+  you.teleport_to(68, 5 + crawl.random2(50))
+end
+local elapsed = crawl.millis() - start
+
+crawl.stderr(string.format("%d abyss shifts in %d ms (%.1f shifts/s)",
+                           shifts, elapsed,
+                           shifts * 1000 / math.max(elapsed, 1)))
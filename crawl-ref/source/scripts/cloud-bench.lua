@@ -0,0 +1,47 @@
+-- Times cloud upkeep on a level full of spreading clouds.
+-- Usage: crawl -script cloud-bench [turns]
+
+local args = script.simple_args()
+local turns = tonumber(args[1]) or 2000
+local cloud_types = { "flame", "freezing vapour", "poison gas", "steam",
+                      "blue smoke", "black smoke" }
+
+local function fill_level()
+  dgn.reset_level()
+  dgn.fill_grd_area(1, 1, dgn.GXM - 2, dgn.GYM - 2, 'floor')
+  you.moveto(2, 2)
+  debug.los_changed()
+end
+
+-- Seed every fourth cell with a long-lived, fast-spreading cloud, and keep
+-- doing so as the old ones fade.
+local function seed_clouds()
+  local placed = 0
+  for y = 2, dgn.GYM - 3, 2 do
+    for x = 2, dgn.GXM - 3, 2 do
+      if dgn.cloud_at(x, y) == "none" then
+        local ctype = cloud_types[crawl.random2(#cloud_types) + 1]
+        dgn.place_cloud(x, y, ctype, 20 + crawl.random2(20), "", 60)
+        placed = placed + 1
+      end
+    end
+  end
+  return placed
+end
+
+debug.disable("death")
+debug.reset_rng(1)
+fill_level()
+seed_clouds()
+
+local start = crawl.millis()
+for turn = 1, turns do
+  debug.manage_clouds()
+  if turn % 10 == 0 then
+    seed_clouds()
+  end
+end
+local elapsed = crawl.millis() - start
+
+crawl.stderr(string.format("%d turns of cloud upkeep in %d ms (%.1f us/turn)",
+                           turns, elapsed, elapsed * 1000 / turns))
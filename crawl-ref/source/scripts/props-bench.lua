@@ -0,0 +1,38 @@
+-- Times property-table lookups: artefact property queries on a pile of
+-- randarts, plus the player resistance checks that consult you.props.
+-- Usage: crawl -script props-bench [rounds]
+
+local args = script.simple_args()
+local rounds = tonumber(args[1]) or 2000
+local kinds = { "randart ring", "randart amulet", "randart long sword",
+                "randart leather armour", "randart cloak", "randart helmet" }
+
+debug.reset_rng(1)
+dgn.reset_level()
+dgn.fill_grd_area(1, 1, dgn.GXM - 2, dgn.GYM - 2, 'floor')
+you.moveto(2, 2)
+
+local arts = {}
+for i = 1, 60 do
+  local x, y = 4 + i % 20, 4 + math.floor(i / 20)
+  dgn.create_item(x, y, kinds[i % #kinds + 1] .. " ident:all")
+  for _, it in ipairs(dgn.items_at(x, y)) do
+    table.insert(arts, it)
+  end
+end
+
+local start = crawl.millis()
+for round = 1, rounds do
+  for _, it in ipairs(arts) do
+    local _ = it.artprops
+  end
+  you.res_fire()
+  you.res_cold()
+  you.res_poison()
+  you.res_shock()
+  you.res_draining()
+end
+local elapsed = crawl.millis() - start
+
+crawl.stderr(string.format("%d rounds over %d artefacts in %d ms (%.1f us/round)",
+                           rounds, #arts, elapsed, elapsed * 1000 / rounds))
@@ -0,0 +1,283 @@
+/**
+ * @file
+ * @brief Batch level generation for many seeds (-seed-scan).
+ *
+ * For each seed in the range, set up the dungeon as a new game would, build
+ * the levels in pregeneration order up to the -depth level, and write one
+ * line of JSON per level listing its features, items and monsters. Unlike
+ * scripts/seed_explorer.lua this needs no debug build or terminal, and with
+ * -jobs it spreads the seeds over several processes. Output stays in seed
+ * order either way.
+**/
+
+#include "AppHdr.h"
+
+#include "seed-scan.h"
+
+#include <cinttypes>
+#include <cstring>
+#ifdef UNIX
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "act-iter.h"
+#include "branch.h"
+#include "dlua.h"
+#include "dungeon.h"
+#include "end.h"
+#include "env.h"
+#include "files.h"
+#include "initfile.h"
+#include "item-prop.h"
+#include "json.h"
+#include "json-wrapper.h"
+#include "los.h"
+#include "message.h"
+#include "monster.h"
+#include "ng-setup.h"
+#include "options.h"
+#include "player.h"
+#include "random.h"
+#include "shopping.h"
+#include "state.h"
+#include "stringutil.h"
+#include "terrain.h"
+#include "tileview.h"
+
+// Features too common to be worth listing.
+static bool _boring_feature(dungeon_feature_type feat)
+{
+    return feat == DNGN_FLOOR || feat == DNGN_UNSEEN || feat_is_wall(feat)
+           || feat_is_closed_door(feat) || feat == DNGN_OPEN_DOOR;
+}
+
+static string _level_record(uint64_t seed, const level_id &lid)
+{
+    JsonWrapper json(json_mkobject());
+    // As a string, since JSON numbers can't hold every 64-bit seed.
+    json_append_member(json.node, "seed",
+                       json_mkstring(make_stringf("%" PRIu64, seed)));
+    json_append_member(json.node, "level", json_mkstring(lid.describe()));
+
+    map<string, int> features;
+    for (rectangle_iterator ri(0); ri; ++ri)
+        if (!_boring_feature(env.grid(*ri)))
+            ++features[dungeon_feature_name(env.grid(*ri))];
+    JsonNode *feature_json = json_mkobject();
+    for (const auto &entry : features)
+    {
+        json_append_member(feature_json, entry.first.c_str(),
+                           json_mknumber(entry.second));
+    }
+    json_append_member(json.node, "features", feature_json);
+
+    JsonNode *items = json_mkarray();
+    for (const item_def &item : env.item)
+        if (item.defined() && in_bounds(item.pos))
+            json_append_element(items, json_mkstring(item.name(DESC_PLAIN,
+                                                               false, true)));
+    json_append_member(json.node, "items", items);
+
+    JsonNode *shop_items = json_mkarray();
+    for (const auto &entry : env.shop)
+        for (const item_def &item : entry.second.stock)
+            if (item.defined())
+            {
+                json_append_element(shop_items,
+                    json_mkstring(item.name(DESC_PLAIN, false, true)));
+            }
+    json_append_member(json.node, "shop_items", shop_items);
+
+    JsonNode *monsters = json_mkarray();
+    for (monster_iterator mi; mi; ++mi)
+        json_append_element(monsters, json_mkstring(mi->name(DESC_PLAIN, true)));
+    json_append_member(json.node, "monsters", monsters);
+
+    return json.to_string() + "\n";
+}
+
+static void _build_level(const level_id &lid)
+{
+    msg::suppress mx;
+    you.level_stack.clear();
+    you.goto_place(lid);
+    env.map_knowledge.init(map_cell());
+    los_changed();
+    tile_init_default_flavour();
+    tile_clear_flavour();
+    tile_new_level(true);
+    builder();
+    update_portal_entrances();
+}
+
+/**
+ * Build one seed's levels, as far as stop, and return their records.
+ * If stop's branch doesn't exist for this seed, stop where it would have
+ * been in the generation order.
+ */
+static string _scan_seed(uint64_t seed, const level_id &stop)
+{
+    Options.seed = seed;
+    // Start each seed from a fresh player and builder state, as a new game
+    // does, so that nothing the previous seed generated (uniques, unique
+    // vaults and artefacts, misc item counts, item sets, dgn lua data)
+    // changes what this one gets.
+    rng::reset();
+    you = player();
+    you.game_seed = crawl_state.seed;
+    // As for mapstat: let "acquire foo" have skill aptitudes to work with.
+    you.species = SP_HUMAN;
+    dlua.callfn("dgn_clear_data", "");
+    initialise_item_sets();
+    dgn_reset_level();
+    dgn_flush_map_memory();
+    initial_dungeon_setup();
+
+    string records;
+    for (branch_type br : pregen_branch_order())
+    {
+        if (br == NUM_BRANCHES || !is_connected_branch(br))
+            continue;
+        const bool last = br == stop.branch;
+        if (brentry[br].is_valid() || br == BRANCH_DUNGEON
+            || br == BRANCH_VESTIBULE)
+        {
+            const int depth = last ? min(stop.depth, brdepth[br])
+                                   : brdepth[br];
+            for (int i = 1; i <= depth; ++i)
+            {
+                const level_id lid(br, i);
+                _build_level(lid);
+                records += _level_record(seed, lid);
+            }
+        }
+        if (last)
+            break;
+    }
+    return records;
+}
+
+#ifdef UNIX
+/**
+ * Scan the seeds in several processes. Job j takes seeds first + j,
+ * first + j + jobs, ... and ends each seed's records with an empty line;
+ * the parent copies them to stdout a seed at a time, in order.
+ */
+static bool _scan_in_jobs(uint64_t first, uint64_t count, int jobs,
+                          const level_id &stop)
+{
+    fflush(stdout);
+    fflush(stderr);
+
+    vector<pair<pid_t, FILE *>> children;
+    for (int job = 0; job < jobs; ++job)
+    {
+        int fds[2];
+        if (pipe(fds) < 0)
+            end(1, true, "Can't create a pipe for seed scan jobs");
+
+        const pid_t pid = fork();
+        if (pid < 0)
+            end(1, true, "Can't start seed scan job");
+        if (pid == 0)
+        {
+            close(fds[0]);
+            for (const auto &child : children)
+                fclose(child.second);
+
+            FILE *out = fdopen(fds[1], "w");
+            for (uint64_t i = job; i < count; i += jobs)
+            {
+                const string records = _scan_seed(first + i, stop) + "\n";
+                if (fputs(records.c_str(), out) == EOF || fflush(out))
+                    _exit(1); // the parent has gone away
+            }
+            _exit(fclose(out) ? 1 : 0);
+        }
+        close(fds[1]);
+        children.emplace_back(pid, fdopen(fds[0], "r"));
+    }
+
+    bool ok = true;
+    char line[4096];
+    for (uint64_t i = 0; ok && i < count; ++i)
+    {
+        FILE *in = children[i % jobs].second;
+        string record;
+        while (true)
+        {
+            if (!fgets(line, sizeof(line), in))
+            {
+                ok = false;
+                break;
+            }
+            if (record.empty() && !strcmp(line, "\n"))
+                break;
+            record += line;
+            if (record.back() == '\n')
+            {
+                fputs(record.c_str(), stdout);
+                record.clear();
+            }
+        }
+        fflush(stdout);
+    }
+
+    for (const auto &child : children)
+    {
+        fclose(child.second);
+        int status;
+        if (waitpid(child.first, &status, 0) < 0 || !WIFEXITED(status)
+            || WEXITSTATUS(status))
+        {
+            ok = false;
+        }
+    }
+    return ok;
+}
+#endif
+
+void seed_scan_run()
+{
+    const uint64_t first = crawl_state.seed_scan_first;
+    const uint64_t last = crawl_state.seed_scan_last;
+    if (!first || last < first)
+        end(1, false, "-seed-scan needs 1 <= <from> <= <to>");
+
+    level_id stop;
+    try
+    {
+        stop = level_id::parse_level_id(crawl_state.seed_scan_depth);
+    }
+    catch (const bad_level_id &err)
+    {
+        end(1, false, "Bad -depth: %s", err.what());
+    }
+    const auto &order = pregen_branch_order();
+    if (find(order.begin(), order.end(), stop.branch) == order.end()
+        || !is_connected_branch(stop.branch))
+    {
+        end(1, false, "-depth must be in a pregenerated branch: %s",
+            crawl_state.seed_scan_depth.c_str());
+    }
+    // A bare branch name means all of it.
+    if (crawl_state.seed_scan_depth.find(':') == string::npos)
+        stop.depth = branches[stop.branch].numlevels;
+
+    const uint64_t count = last - first + 1;
+#ifdef UNIX
+    const int jobs = (int) min<uint64_t>(SysEnv.map_gen_jobs, count);
+    if (jobs > 1)
+    {
+        if (!_scan_in_jobs(first, count, jobs, stop))
+            end(1, false, "A seed scan job failed");
+        return;
+    }
+#endif
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        fputs(_scan_seed(first + i, stop).c_str(), stdout);
+        fflush(stdout);
+    }
+}
@@ -0,0 +1,8 @@
+/**
+ * @file
+ * @brief Batch level generation for many seeds (-seed-scan).
+**/
+
+#pragma once
+
+void seed_scan_run();
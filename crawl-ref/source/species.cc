@@ -728,6 +728,7 @@ static void _swap_equip(equipment_type a, equipment_type b)
     bool tmp = you.melded[a];
     you.melded.set(a, you.melded[b]);
     you.melded.set(b, tmp);
+    you.equipment_changed();
 }
 
 /**
@@ -835,6 +836,7 @@ void change_species_to(species_type sp)
                 // Unwear items without the usual processing.
                 you.equip[i] = -1;
                 you.melded.set(i, false);
+                you.equipment_changed();
             }
         }
     }
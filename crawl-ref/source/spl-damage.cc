@@ -3097,8 +3097,8 @@ static bool _elec_not_immune(const actor *act)
 
 coord_def get_thunderbolt_last_aim(actor *caster)
 {
-    const int &last_turn = caster->props[THUNDERBOLT_LAST_KEY].get_int();
-    const coord_def &last_aim = caster->props[THUNDERBOLT_AIM_KEY].get_coord();
+    const int last_turn = caster->props[THUNDERBOLT_LAST_KEY].get_int();
+    const coord_def last_aim = caster->props[THUNDERBOLT_AIM_KEY].get_coord();
 
     // check against you.pos() in case the player has moved instantaneously,
     // via mesmerise, wjc, etc. In principle, this should probably also
@@ -3111,16 +3111,13 @@ coord_def get_thunderbolt_last_aim(actor *caster)
 
 static void _set_thunderbolt_last_aim(actor *caster, coord_def aim)
 {
-    int &last_turn = caster->props[THUNDERBOLT_LAST_KEY].get_int();
-    coord_def &last_aim = caster->props[THUNDERBOLT_AIM_KEY].get_coord();
-
-    last_turn = you.num_turns;
-    last_aim = aim;
+    caster->props[THUNDERBOLT_LAST_KEY].get_int() = you.num_turns;
+    caster->props[THUNDERBOLT_AIM_KEY].get_coord() = aim;
 }
 
 dice_def thunderbolt_damage(int power, int arc)
 {
-    const int &charges = you.props[THUNDERBOLT_CHARGES_KEY].get_int();
+    const int charges = you.props[THUNDERBOLT_CHARGES_KEY].get_int();
     ASSERT(charges <= LIGHTNING_MAX_CHARGE);
 
     int charge_boost = 0;
@@ -3136,12 +3133,12 @@ dice_def thunderbolt_damage(int power, int arc)
 
 spret cast_thunderbolt(actor *caster, int pow, coord_def aim, bool fail)
 {
-    int &charges = caster->props[THUNDERBOLT_CHARGES_KEY].get_int();
-    ASSERT(charges <= LIGHTNING_MAX_CHARGE);
+    ASSERT(caster->props[THUNDERBOLT_CHARGES_KEY].get_int()
+           <= LIGHTNING_MAX_CHARGE);
 
     coord_def prev = get_thunderbolt_last_aim(caster);
     if (!in_bounds(prev))
-        charges = 0;
+        caster->props[THUNDERBOLT_CHARGES_KEY] = 0;
 
     targeter_thunderbolt hitfunc(caster, spell_range(SPELL_THUNDERBOLT, pow),
                                  prev);
@@ -3211,6 +3208,7 @@ spret cast_thunderbolt(actor *caster, int pow, coord_def aim, bool fail)
 
     _set_thunderbolt_last_aim(caster, aim);
 
+    int &charges = caster->props[THUNDERBOLT_CHARGES_KEY].get_int();
     if (charges < LIGHTNING_MAX_CHARGE)
         charges++;
 
@@ -3827,8 +3825,7 @@ void handle_flame_wave()
     if (!you.props.exists(FLAME_WAVE_KEY))
         return;
 
-    int &lvl = you.props[FLAME_WAVE_KEY].get_int();
-    ++lvl;
+    const int lvl = ++you.props[FLAME_WAVE_KEY].get_int();
     if (lvl == 1) // just cast it this turn
         return;
 
@@ -14,6 +14,7 @@
 #endif
 
 #include "end.h"
+#include "stringutil.h"
 #include "syscalls.h"
 
 #ifdef USE_SQLITE_DBM
@@ -47,9 +48,11 @@ private:
     int nretries;
 };
 
-SQL_DBM::SQL_DBM(const string &dbname, bool _readonly, bool do_open)
+SQL_DBM::SQL_DBM(const string &dbname, bool _readonly, bool do_open,
+                 bool _immutable)
     : error(), errc(SQLITE_OK), db(nullptr), s_insert(nullptr), s_remove(nullptr),
-      s_query(nullptr), s_iterator(nullptr), dbfile(dbname), readonly(_readonly)
+      s_query(nullptr), s_iterator(nullptr), dbfile(dbname),
+      readonly(_readonly || _immutable), immutable(_immutable)
 {
     if (do_open && !dbfile.empty())
         open();
@@ -77,6 +80,24 @@ bool SQL_DBM::is_open() const
     return !!db;
 }
 
+#ifndef ANCIENT_SQLITE
+// A file: URI for path, with the immutable flag set.
+static string _immutable_uri(const string &path)
+{
+    string uri = "file:";
+    for (const char c : path)
+    {
+        if (c == '?' || c == '#' || c == '%')
+            uri += make_stringf("%%%02X", (unsigned char)c);
+        else if (c == '\\')
+            uri += '/';
+        else
+            uri += c;
+    }
+    return uri + "?immutable=1";
+}
+#endif
+
 int SQL_DBM::open(const string &s)
 {
     close();
@@ -104,12 +125,18 @@ From SQLite's documentation:
 
 ... which saves us a lot of trouble.
 */
-    if (ec(sqlite3_open_v2(
-                dbfile.c_str(), &db,
-                readonly ? SQLITE_OPEN_READONLY :
-                (SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE),
-                nullptr
-              )) != SQLITE_OK)
+    string filename = dbfile;
+    int flags = readonly ? SQLITE_OPEN_READONLY
+                         : (SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+#ifndef ANCIENT_SQLITE
+    if (immutable)
+    {
+        filename = _immutable_uri(dbfile);
+        flags |= SQLITE_OPEN_URI;
+    }
+#endif
+    if (ec(sqlite3_open_v2(filename.c_str(), &db, flags, nullptr))
+        != SQLITE_OK)
     {
         const string saveerr = error;
         const int serrc = errc;
@@ -119,6 +146,13 @@ From SQLite's documentation:
         return errc;
     }
 
+    if (immutable)
+    {
+        // The schema is already there, and the whole file can be mapped.
+        return ec(sqlite3_exec(db, "PRAGMA mmap_size=268435456;",
+                               nullptr, nullptr, nullptr));
+    }
+
     init_schema();
     return errc;
 }
@@ -405,6 +439,18 @@ SQL_DBM *dbm_open(const char *filename, int mode, int)
     return n;
 }
 
+SQL_DBM *dbm_open_immutable(const char *filename)
+{
+    SQL_DBM *n = new SQL_DBM(filename, true, true, true);
+    if (!n->is_open())
+    {
+        delete n;
+        return nullptr;
+    }
+
+    return n;
+}
+
 int dbm_close(SQL_DBM *db)
 {
     delete db;
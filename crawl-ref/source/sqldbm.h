@@ -47,7 +47,8 @@ private:
 class SQL_DBM
 {
 public:
-    SQL_DBM(const string &db = "", bool readonly = true, bool open = false);
+    SQL_DBM(const string &db = "", bool readonly = true, bool open = false,
+            bool immutable = false);
     ~SQL_DBM();
 
     bool is_open() const;
@@ -88,9 +89,13 @@ private:
     sqlite3_stmt *s_iterator;
     string       dbfile;
     bool readonly;
+    bool immutable;
 };
 
 SQL_DBM  *dbm_open(const char *filename, int open_mode, int permissions);
+// Open a database that nothing will write to while it's open, skipping
+// SQLite's locking and change detection and mapping it into memory.
+SQL_DBM  *dbm_open_immutable(const char *filename);
 int   dbm_close(SQL_DBM *db);
 
 sql_datum dbm_fetch(SQL_DBM *db, const sql_datum &key);
@@ -0,0 +1,111 @@
+/**
+ * @file
+ * @brief Timing of the phases of game launch, for -startup-profile.
+**/
+
+#include "AppHdr.h"
+
+#include "startup-profile.h"
+
+#include <chrono>
+#include <ctime>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "state.h"
+
+struct phase_record
+{
+    const char *name;
+    int depth;
+    chrono::steady_clock::time_point wall_start;
+    clock_t cpu_start;
+    int64_t heap_start;
+    double wall_ms;
+    double cpu_ms;
+    int64_t heap_bytes;
+};
+
+static vector<phase_record> phases;
+static int phase_depth = 0;
+
+// Bytes currently allocated from the heap, or -1 if we can't tell.
+static int64_t _heap_in_use()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    return mallinfo2().uordblks;
+#elif defined(__GLIBC__)
+    return (unsigned int) mallinfo().uordblks;
+#else
+    return -1;
+#endif
+}
+
+static double _cpu_ms(clock_t ticks)
+{
+    return ticks * 1000.0 / CLOCKS_PER_SEC;
+}
+
+startup_phase::startup_phase(const char *name)
+    : index(-1)
+{
+    if (!crawl_state.startup_profile)
+        return;
+
+    index = phases.size();
+    phase_record rec;
+    rec.name = name;
+    rec.depth = phase_depth++;
+    rec.wall_ms = rec.cpu_ms = 0;
+    rec.heap_bytes = 0;
+    rec.heap_start = _heap_in_use();
+    rec.cpu_start = clock();
+    rec.wall_start = chrono::steady_clock::now();
+    phases.push_back(rec);
+}
+
+startup_phase::~startup_phase()
+{
+    if (index < 0)
+        return;
+
+    phase_record &rec = phases[index];
+    const chrono::duration<double, milli> wall =
+        chrono::steady_clock::now() - rec.wall_start;
+    rec.wall_ms = wall.count();
+    rec.cpu_ms = _cpu_ms(clock() - rec.cpu_start);
+    const int64_t heap = _heap_in_use();
+    rec.heap_bytes = heap < 0 ? -1 : heap - rec.heap_start;
+    --phase_depth;
+}
+
+static void _report_line(FILE *out, const char *name, int depth,
+                         double wall_ms, double cpu_ms, int64_t heap_bytes)
+{
+    fprintf(out, "{\"phase\":\"%s\",\"depth\":%d,\"wall_ms\":%.3f,"
+                 "\"cpu_ms\":%.3f,\"heap_bytes\":",
+            name, depth, wall_ms, cpu_ms);
+    if (heap_bytes < 0)
+        fprintf(out, "null}\n");
+    else
+        fprintf(out, "%" PRId64 "}\n", heap_bytes);
+}
+
+void startup_profile_report(FILE *out)
+{
+    double wall_total = 0;
+    for (const phase_record &rec : phases)
+    {
+        _report_line(out, rec.name, rec.depth, rec.wall_ms, rec.cpu_ms,
+                     rec.heap_bytes);
+        if (rec.depth == 0)
+            wall_total += rec.wall_ms;
+    }
+
+    // CPU time and heap use are for the whole process so far, including
+    // anything that happened outside the phases.
+    _report_line(out, "total", 0, wall_total, _cpu_ms(clock()),
+                 _heap_in_use());
+    fflush(out);
+}
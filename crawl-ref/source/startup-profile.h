@@ -0,0 +1,28 @@
+/**
+ * @file
+ * @brief Timing of the phases of game launch, for -startup-profile.
+**/
+
+#pragma once
+
+#include <cstdio>
+
+// Measures one phase of launching the game while -startup-profile is on,
+// and does nothing otherwise. Phases may nest; each one's totals include
+// those of the phases inside it.
+class startup_phase
+{
+public:
+    explicit startup_phase(const char *name);
+    ~startup_phase();
+
+    startup_phase(const startup_phase &) = delete;
+    startup_phase &operator=(const startup_phase &) = delete;
+
+private:
+    int index;
+};
+
+// Write one JSON object per phase, in the order the phases started,
+// followed by a "total" line.
+void startup_profile_report(FILE *out);
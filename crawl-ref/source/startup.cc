@@ -48,6 +48,8 @@
 #include "spl-book.h"
 #include "spl-util.h"
 #include "stairs.h"
+#include "seed-scan.h"
+#include "startup-profile.h"
 #include "state.h"
 #include "status.h"
 #include "stringutil.h"
@@ -79,18 +81,9 @@ static void _loading_message(string m)
 #endif
 }
 
-// Initialise a whole lot of stuff...
-static void _initialize()
+static void _init_tables()
 {
-    Options.fixup_options();
-
-    you.symbol = MONS_PLAYER;
-    msg::initialise_mpr_streams();
-
-    rng::seed(); // don't use any chosen seed yet
-
-    clua.init_libraries();
-
+    startup_phase phase("tables");
     init_char_table(Options.char_set);
     init_show_table();
     init_monster_symbols();
@@ -106,6 +99,56 @@ static void _initialize()
     // and init_show_table() have been called, so that the glyphs will
     // be set to use with item_names_by_glyph_cache.
     init_item_name_cache();
+}
+
+/**
+ * Do the parts of start-up that don't depend on the player or their options,
+ * so that a -zygote server can do them once for all the games it forks.
+ * _initialize() then skips them.
+ */
+void startup_preinit()
+{
+    _init_tables();
+
+    {
+        startup_phase phase("dungeon lua");
+        init_dungeon_lua();
+    }
+
+    // Make sure the databases are up to date, but don't keep them open:
+    // each child opens its own handles.
+    {
+        startup_phase phase("databases");
+        databaseSystemInit();
+        databaseSystemShutdown();
+    }
+
+    {
+        startup_phase phase("maps");
+        read_maps();
+        run_map_global_preludes();
+    }
+
+    precompute_rays();
+    crawl_state.preinitialised = true;
+}
+
+// Initialise a whole lot of stuff...
+static void _initialize()
+{
+    Options.fixup_options();
+
+    you.symbol = MONS_PLAYER;
+    msg::initialise_mpr_streams();
+
+    rng::seed(); // don't use any chosen seed yet
+
+    {
+        startup_phase phase("lua");
+        clua.init_libraries();
+    }
+
+    _init_tables();
 
     unwind_bool no_more(crawl_state.show_more_prompt, false);
 
@@ -116,7 +159,7 @@ static void _initialize()
     reset_all_monsters();
     init_anon();
 
-    env.igrid.init(NON_ITEM);
+    clear_item_grid();
     env.mgrid.init(NON_MONSTER);
     env.map_knowledge.init(map_cell());
     env.pgrid.init(terrain_property_t{});
@@ -125,7 +168,11 @@ static void _initialize()
     you.unique_items.init(UNIQ_NOT_EXISTS);
 
     // Set up the Lua interpreter for the dungeon builder.
-    init_dungeon_lua();
+    if (!crawl_state.preinitialised)
+    {
+        startup_phase phase("dungeon lua");
+        init_dungeon_lua();
+    }
 
 #ifdef USE_TILE_LOCAL
     // Draw the splash screen before the database gets initialised as that
@@ -134,25 +181,49 @@ static void _initialize()
     loading_screen_open();
 #endif
 
+    if (!crawl_state.prebuild_db_dir.empty())
+    {
+        databasePrebuild(crawl_state.prebuild_db_dir);
+        end(0);
+    }
+
     // Initialise internal databases.
     _loading_message("Loading databases...");
-    databaseSystemInit();
+    {
+        startup_phase phase("databases");
+        databaseSystemInit();
+    }
 
     _loading_message("Loading spells and features...");
-    init_feat_desc_cache();
-    init_spell_name_cache();
+    {
+        startup_phase phase("description caches");
+        init_feat_desc_cache();
+        init_spell_name_cache();
 #ifdef DEBUG
-    validate_spellbooks();
+        validate_spellbooks();
 #endif
+    }
 
     // Read special levels and vaults.
     _loading_message("Loading maps...");
-    read_maps();
-    run_map_global_preludes();
+    if (!crawl_state.preinitialised)
+    {
+        startup_phase phase("maps");
+        read_maps();
+        run_map_global_preludes();
+    }
 
     if (crawl_state.build_db)
         end(0);
 
+    if (crawl_state.startup_profile)
+    {
+        // Otherwise done when the first level is shown.
+        precompute_rays();
+        startup_profile_report(stdout);
+        end(0);
+    }
+
     crawl_state.use_des_cache = true;
 
 #ifdef USE_TILE_LOCAL
@@ -161,6 +232,13 @@ static void _initialize()
 
     you.game_seed = crawl_state.seed;
 
+    if (crawl_state.seed_scan)
+    {
+        release_cli_signals();
+        seed_scan_run();
+        end(0, false);
+    }
+
 #ifdef DEBUG_STATISTICS
     if (crawl_state.map_stat_gen)
     {
@@ -5,5 +5,6 @@
 
 #pragma once
 
+void startup_preinit();
 bool startup_step();
 void cio_init();
@@ -27,6 +27,7 @@
 #include "god-passive.h"
 #include "hints.h"
 #include "invent.h"
+#include "item-name.h"
 #include "item-prop.h"
 #include "item-status-flag-type.h"
 #include "items.h"
@@ -168,7 +169,7 @@ static void _fully_identify_item(item_def *item)
 // Stash
 // ----------------------------------------------------------------------
 
-Stash::Stash(coord_def pos_) : items()
+Stash::Stash(coord_def pos_) : items(), item_names(), item_names_gen(0)
 {
     // First, fix what square we're interested in
     if (pos_.origin())
@@ -236,6 +237,8 @@ bool Stash::unmark_trapping_nets()
     for (auto &item : items)
         if (item_is_stationary_net(item))
             item.net_placed = false, changed = true;
+    if (changed)
+        item_names.clear();
     return changed;
 }
 
@@ -263,6 +266,7 @@ void Stash::update()
 
     // Zap existing items
     items.clear();
+    item_names.clear();
 
     if (!_grid_has_perceived_item(pos))
     {
@@ -334,13 +338,30 @@ string Stash::stash_item_name(const item_def &item)
     return name + " (gone by now)";
 }
 
+/**
+ * The stash_item_name() of items[i]. Searches go over every stash on every
+ * level, so the names are kept until the items change or
+ * item_name_generation() says that names may have.
+ */
+const string &Stash::cached_item_name(size_t i) const
+{
+    if (item_names.size() != items.size()
+        || item_names_gen != item_name_generation())
+    {
+        item_names.clear();
+        for (const item_def &item : items)
+            item_names.push_back(stash_item_name(item));
+        item_names_gen = item_name_generation();
+    }
+    return item_names[i];
+}
+
 string Stash::description() const
 {
     if (items.empty())
         return "";
 
-    const item_def &item = items[0];
-    string desc = stash_item_name(item);
+    string desc = cached_item_name(0);
 
     size_t sz = items.size();
     if (sz > 1)
@@ -366,9 +387,10 @@ vector<stash_search_result> Stash::matches_search(
     if (empty())
         return results;
 
-    for (const item_def &item : items)
+    for (size_t i = 0; i < items.size(); ++i)
     {
-        const string s   = stash_item_name(item);
+        const item_def &item = items[i];
+        const string &s  = cached_item_name(i);
         const string ann = stash_annotate_item(STASH_LUA_SEARCH_ANNOTATE, &item);
         string haystack = prefix + " " + ann + " " + s;
         if (is_dumpable_artefact(item))
@@ -423,6 +445,7 @@ void Stash::_update_corpses(int rot_time)
         }
         item.stash_freshness = static_cast<short>(new_rot);
     }
+    item_names.clear();
 }
 
 void Stash::_update_identification()
@@ -432,6 +455,7 @@ void Stash::_update_identification()
         god_id_item(items[i]);
         maybe_identify_base_type(items[i]);
     }
+    item_names.clear();
 }
 
 void Stash::add_item(item_def &item, bool add_to_front)
@@ -443,6 +467,7 @@ void Stash::add_item(item_def &item, bool add_to_front)
         items.insert(items.begin(), item);
     else
         items.push_back(item);
+    item_names.clear();
 
     seen_item(item);
 
@@ -547,6 +572,7 @@ void Stash::load(reader& inf)
 
     // Zap out item vector, in case it's in use (however unlikely)
     items.clear();
+    item_names.clear();
     // Read in the items
     for (int i = 0; i < count; ++i)
     {
@@ -1519,7 +1545,8 @@ public:
           request_toggle_filter_useless(false),
           sort_style(sort_style_),
           filtered(filtered_),
-          search(nullptr)
+          search(nullptr),
+          num_results(0)
     { }
 
 public:
@@ -1528,6 +1555,7 @@ public:
     const char* sort_style;
     const char* filtered;
     base_pattern *search;
+    int num_results;
 
 protected:
     bool process_key(int key) override;
@@ -1574,7 +1602,8 @@ protected:
 
 formatted_string StashSearchMenu::calc_title()
 {
-    const int num_matches = item_count(false);
+    // Not item_count(false), which would make every entry.
+    const int num_matches = num_results;
     const int num_alt_matches = title->quantity;
     formatted_string fs;
     fs.textcolour(title->colour);
@@ -1648,7 +1677,7 @@ bool StashSearchMenu::examine_index(int i)
 {
     ASSERT(i >= 0 && i < static_cast<int>(items.size()));
 
-    const StashMenuEntry *sme = dynamic_cast<const StashMenuEntry *>(items[i]);
+    const StashMenuEntry *sme = dynamic_cast<const StashMenuEntry *>(get_entry(i));
     const stash_search_result *res = sme->get_search_result();
 
     if (res->item.defined())
@@ -1677,6 +1706,78 @@ bool StashSearchMenu::examine_index(int i)
     return true;
 }
 
+static MenuEntry *_stash_result_entry(stash_search_result &res, int hotkey,
+                                      bool here, Menu::action menu_action)
+{
+    ostringstream matchtitle;
+    if (!res.in_inventory)
+    {
+        if (const uint8_t waypoint = travel_cache.is_waypoint(res.pos))
+            matchtitle << "(" << waypoint << ") ";
+        if (here)
+            matchtitle << "[right here] ";
+        else
+            matchtitle << "[" << res.pos.id.describe() << "] ";
+    }
+
+    matchtitle << res.match;
+    if (res.duplicates > 0)
+    {
+        matchtitle << " (" << res.duplicates << " further duplicate" <<
+            (res.duplicates == 1 ? "" : "s");
+        if (res.duplicates != res.duplicate_piles  // piles are only
+                                                   // meaningful for items
+            && res.match_type == MATCH_ITEM)
+        {
+            matchtitle << " in " << res.duplicate_piles
+                       << " pile" << (res.duplicate_piles == 1 ? "" : "s");
+        }
+        matchtitle << ")";
+    }
+
+    int colour = MENU_ITEM_STOCK_COLOUR;
+    if (res.shop && !res.shop->is_visited()) // ???
+        colour = CYAN;
+    else if (res.item.defined())
+    {
+        const int itemcol = menu_colour(res.item.name(DESC_PLAIN).c_str(),
+                                    item_prefix(res.item, false), "pickup", false);
+        if (itemcol != -1)
+            colour = itemcol;
+    }
+
+    StashMenuEntry *me = new StashMenuEntry(matchtitle.str(), MEL_ITEM,
+                                        colour, 1, hotkey, here);
+    me->data = &res;
+
+    // set items on this position to darkgrey if we're in travel mode
+    me->set_here_enabled(menu_action != Menu::ACT_EXECUTE);
+
+    if (res.item.defined())
+    {
+        vector<tile_def> item_tiles;
+        get_tiles_for_item(res.item, item_tiles, false);
+        for (const auto &tile : item_tiles)
+            me->add_tile(tile);
+    }
+    else if (res.shop)
+        me->add_tile(tile_def(tileidx_shop(&res.shop->shop)));
+    else if (feat_is_trap(res.feat))
+        me->add_tile(tile_def(tileidx_trap(res.trap)));
+    else if (feat_is_runed(res.feat))
+    {
+        // Handle large doors and huge gates
+        me->add_tile(tile_def(tileidx_feature_base(res.feat)));
+    }
+    else
+    {
+        const dungeon_feature_type feat = feat_by_desc(res.match);
+        me->add_tile(tile_def(tileidx_feature_base(feat)));
+    }
+
+    return me;
+}
+
 // Returns true to request redisplay if display method was toggled
 bool StashTracker::display_search_results(
     vector<stash_search_result> &results_in,
@@ -1712,23 +1813,31 @@ bool StashTracker::display_search_results(
     bool need_here_subtitle = stashmenu.menu_action == Menu::ACT_EXECUTE
                                                             && sort_by_dist;
     bool need_there_subtitle = false;
-    StashMenuEntry *first_hdr = nullptr;
+
+    // Naming and colouring results is slow, and there can be thousands of
+    // them, so the menu makes entries as they are shown. This pass just
+    // works out where each result and subtitle goes.
+    struct result_row
+    {
+        stash_search_result *res; // nullptr for subtitles
+        int hotkey;
+        bool here;
+    };
+    vector<result_row> rows;
+    int here_subtitle = -1;
 
     menu_letter hotkey;
     int initial_snap = -1;
     for (stash_search_result &res : *results)
     {
-        ostringstream matchtitle;
         const bool here = res.pos.id == level_id::current() && res.pos.pos == you.pos();
 
         // handled on first result, show the `here` subtitle if there is
         // an item of some kind here
         if (need_here_subtitle && (here || res.in_inventory))
         {
-            // LIGHTCYAN for better contrast. XX change the default?
-            first_hdr = new StashMenuEntry("Results at your position",
-                                                    MEL_SUBTITLE, LIGHTCYAN);
-            stashmenu.add_entry(first_hdr);
+            here_subtitle = rows.size();
+            rows.push_back({nullptr, 0, false});
             // only show the `elsewhere` subtitle if there are any `here`
             // results
             need_there_subtitle = true;
@@ -1738,83 +1847,35 @@ bool StashTracker::display_search_results(
 
         if (need_there_subtitle && !(here || res.in_inventory))
         {
-            const string cycle_keyhelp = " <lightgrey>([<w>,</w>] to cycle)</lightgrey>";
-            stashmenu.add_entry(new StashMenuEntry(
-                "Results elsewhere" + cycle_keyhelp, MEL_SUBTITLE, LIGHTCYAN));
-            ASSERT(first_hdr);
-            first_hdr->text += cycle_keyhelp;
+            rows.push_back({nullptr, 0, false});
             need_there_subtitle = false;
-            initial_snap = static_cast<int>(stashmenu.item_count());
-        }
-
-        if (!res.in_inventory)
-        {
-            if (const uint8_t waypoint = travel_cache.is_waypoint(res.pos))
-                matchtitle << "(" << waypoint << ") ";
-            if (here)
-                matchtitle << "[right here] ";
-            else
-                matchtitle << "[" << res.pos.id.describe() << "] ";
-        }
-
-        matchtitle << res.match;
-        if (res.duplicates > 0)
-        {
-            matchtitle << " (" << res.duplicates << " further duplicate" <<
-                (res.duplicates == 1 ? "" : "s");
-            if (res.duplicates != res.duplicate_piles  // piles are only
-                                                       // meaningful for items
-                && res.match_type == MATCH_ITEM)
-            {
-                matchtitle << " in " << res.duplicate_piles
-                           << " pile" << (res.duplicate_piles == 1 ? "" : "s");
-            }
-            matchtitle << ")";
+            initial_snap = static_cast<int>(rows.size());
         }
 
-        int colour = MENU_ITEM_STOCK_COLOUR;
-        if (res.shop && !res.shop->is_visited()) // ???
-            colour = CYAN;
-        else if (res.item.defined())
-        {
-            const int itemcol = menu_colour(res.item.name(DESC_PLAIN).c_str(),
-                                        item_prefix(res.item, false), "pickup", false);
-            if (itemcol != -1)
-                colour = itemcol;
-        }
-
-        StashMenuEntry *me = new StashMenuEntry(matchtitle.str(), MEL_ITEM,
-                                            colour, 1, (int) hotkey, here);
-        me->data = &res;
-
-        // set items on this position to darkgrey if we're in travel mode
-        me->set_here_enabled(stashmenu.menu_action != Menu::ACT_EXECUTE);
+        rows.push_back({&res, (int) hotkey, here});
+        hotkey++;
+    }
 
-        if (res.item.defined())
-        {
-            vector<tile_def> item_tiles;
-            get_tiles_for_item(res.item, item_tiles, false);
-            for (const auto &tile : item_tiles)
-                me->add_tile(tile);
-        }
-        else if (res.shop)
-            me->add_tile(tile_def(tileidx_shop(&res.shop->shop)));
-        else if (feat_is_trap(res.feat))
-            me->add_tile(tile_def(tileidx_trap(res.trap)));
-        else if (feat_is_runed(res.feat))
-        {
-            // Handle large doors and huge gates
-            me->add_tile(tile_def(tileidx_feature_base(res.feat)));
-        }
-        else
+    // with both subtitles, you can cycle between them
+    const string cycle_keyhelp = initial_snap > 0
+        ? " <lightgrey>([<w>,</w>] to cycle)</lightgrey>" : "";
+    stashmenu.num_results = results->size();
+    stashmenu.set_entry_source(rows.size(), [&](int i) -> MenuEntry*
+    {
+        const result_row &row = rows[i];
+        if (!row.res)
         {
-            const dungeon_feature_type feat = feat_by_desc(res.match);
-            me->add_tile(tile_def(tileidx_feature_base(feat)));
+            // LIGHTCYAN for better contrast. XX change the default?
+            return new StashMenuEntry(i == here_subtitle
+                                        ? "Results at your position"
+                                          + cycle_keyhelp
+                                        : "Results elsewhere" + cycle_keyhelp,
+                                      MEL_SUBTITLE, LIGHTCYAN);
         }
-
-        stashmenu.add_entry(me);
-        hotkey++;
-    }
+        return _stash_result_entry(*row.res, row.hotkey, row.here,
+                                   stashmenu.menu_action);
+    },
+    [&](int i) { return rows[i].res ? rows[i].hotkey : 0; });
     if (initial_snap > 0)
         stashmenu.set_hovered(initial_snap);
 
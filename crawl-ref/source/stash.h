@@ -61,6 +61,7 @@ public:
     bool is_visited() const {  return visited; }
 
 private:
+    const string &cached_item_name(size_t i) const;
     void _update_corpses(int rot_time);
     void _update_identification();
     void add_item(item_def &item, bool add_to_front = false);
@@ -74,6 +75,10 @@ private:
 
     vector<item_def> items;
 
+    // stash_item_name() of each item, as of item_names_gen. Not saved.
+    mutable vector<string> item_names;
+    mutable unsigned int item_names_gen;
+
     static bool are_items_same(const item_def &, const item_def &,
                                bool exact = false);
 
@@ -43,7 +43,12 @@ game_state::game_state()
       last_type(GAME_TYPE_UNSPECIFIED), last_game_exit(game_exit::unknown),
       marked_as_won(false), arena_suspended(false),
       generating_level(false), dump_maps(false), test(false), script(false),
-      build_db(false), use_des_cache(true), tests_selected(),
+      build_db(false), startup_profile(false), preinitialised(false),
+      seed_scan(false), seed_scan_first(0), seed_scan_last(0),
+      seed_scan_depth("Tomb:3"),
+      use_des_cache(true), check_tracers(false),
+      check_equip_cache(false),
+      tests_selected(),
 #ifdef DGAMELAUNCH
       throttle(true),
       bypassed_startup_menu(true),
@@ -86,7 +86,21 @@ struct game_state
     bool test_list;         // Show available tests and exit.
     bool script;            // Set if we want to run a Lua script and exit.
     bool build_db;          // Set if we want to rebuild the db and exit.
+    string prebuild_db_dir; // Set if we want to write the text dbs for
+                            // installing there, and exit.
+    bool startup_profile;   // Set if we want to time game launch and exit.
+    string turn_log_file;   // Write the wall time of each turn here.
+    string zygote_socket;   // Serve fork requests on this socket.
+    bool preinitialised;    // Set if startup_preinit() has run.
+    bool seed_scan;         // Set if we want to scan seeds and exit.
+    uint64_t seed_scan_first; // The range of seeds to scan.
+    uint64_t seed_scan_last;
+    string seed_scan_depth; // Scan each seed's levels down to here.
     bool use_des_cache;
+    bool check_tracers;     // Cross-check monster tracers against the full
+                            // beam code (slow; for tests).
+    bool check_equip_cache; // Cross-check cached equipment totals on every
+                            // query (slow; for tests).
     vector<string> tests_selected; // Tests to be run.
     vector<string> script_args;    // Arguments to scripts.
 
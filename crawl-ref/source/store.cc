@@ -9,6 +9,8 @@
 #include "store.h"
 
 #include <algorithm>
+#include <cstring>
+#include <deque>
 
 #include "dlua.h"
 #include "monster.h"
@@ -46,6 +48,14 @@ CrawlStoreValue::CrawlStoreValue(const CrawlStoreValue &other)
     *this = other;
 }
 
+CrawlStoreValue::CrawlStoreValue(CrawlStoreValue &&other) noexcept
+    : type(other.type), flags(other.flags), val(other.val)
+{
+    other.type    = SV_NONE;
+    other.flags   = SFLAG_UNSET;
+    other.val.ptr = nullptr;
+}
+
 CrawlStoreValue::CrawlStoreValue(const store_flags _flags,
                                  const store_val_type _type)
     : type(_type), flags(_flags)
@@ -402,6 +412,33 @@ CrawlStoreValue &CrawlStoreValue::operator = (const CrawlStoreValue &other)
     return *this;
 }
 
+// Moving swaps the two values' contents, so our old value (if any) is freed
+// along with the moved-from one. This is what lets CrawlHashTable and
+// CrawlVector shuffle their entries around without deep copies, and without
+// invalidating references to heap-allocated values.
+CrawlStoreValue &CrawlStoreValue::operator = (CrawlStoreValue &&other) noexcept
+{
+    if (!(flags & SFLAG_UNSET) && !(other.flags & SFLAG_UNSET)
+        && (flags & SFLAG_CONST_TYPE))
+    {
+        ASSERT(type == SV_NONE || type == other.type);
+    }
+
+    const store_val_type old_type  = type;
+    const store_flags    old_flags = flags;
+    const StoreUnion     old_val   = val;
+
+    type  = other.type;
+    flags = other.flags;
+    val   = other.val;
+
+    other.type  = old_type;
+    other.flags = old_flags;
+    other.val   = old_val;
+
+    return *this;
+}
+
 ///////////////////////////////////
 // Meta-data accessors and changers
 store_flags CrawlStoreValue::get_flags() const
@@ -1216,10 +1253,20 @@ void CrawlHashTable::write(writer &th) const
 
     marshallUnsigned(th, size());
 
-    for (const auto &entry : *this)
+    // Key ids depend on the order keys were first seen in this session, so
+    // write the entries sorted by name to keep saves reproducible.
+    vector<const value_type *> sorted;
+    sorted.reserve(entries.size());
+    for (const auto &entry : entries)
+        sorted.push_back(&entry);
+    sort(sorted.begin(), sorted.end(),
+         [](const value_type *a, const value_type *b)
+         { return a->first.name() < b->first.name(); });
+
+    for (const value_type *entry : sorted)
     {
-        marshallString(th, entry.first);
-        entry.second.write(th);
+        marshallString(th, entry->first);
+        entry->second.write(th);
     }
 
     ASSERT_VALIDITY();
@@ -1259,14 +1306,188 @@ static map<string, int> accesses;
 # define ACCESS(x)
 #endif
 
+//////////////////
+// Key interning
+
+namespace
+{
+    // An open-addressed table of interned key strings. Slots hold a key
+    // id plus one, with zero marking an empty slot. The strings live in a
+    // deque so that references handed out by CrawlHashKey::name() remain
+    // valid as more keys are added.
+    struct hash_key_table
+    {
+        deque<string>    names;
+        vector<uint32_t> hashes;
+        vector<uint32_t> slots;
+
+        hash_key_table() : slots(1024, 0) { }
+
+        static uint32_t hash(const char *key, size_t &len)
+        {
+            // FNV-1a
+            uint32_t h = 2166136261u;
+            const char *p = key;
+            for (; *p; ++p)
+            {
+                h ^= static_cast<uint8_t>(*p);
+                h *= 16777619u;
+            }
+            len = p - key;
+            return h;
+        }
+
+        // Returns the slot for key: either the one holding it, or the
+        // empty one it would be inserted into.
+        size_t probe(const char *key, size_t len, uint32_t h) const
+        {
+            const size_t mask = slots.size() - 1;
+            for (size_t i = h & mask;; i = (i + 1) & mask)
+            {
+                const uint32_t slot = slots[i];
+                if (!slot)
+                    return i;
+                const uint32_t id = slot - 1;
+                if (hashes[id] == h && names[id].size() == len
+                    && !memcmp(names[id].data(), key, len))
+                {
+                    return i;
+                }
+            }
+        }
+
+        uint32_t find(const char *key) const
+        {
+            size_t len;
+            const uint32_t h = hash(key, len);
+            const uint32_t slot = slots[probe(key, len, h)];
+            return slot ? slot - 1 : CrawlHashKey::NONE;
+        }
+
+        uint32_t intern(const char *key)
+        {
+            size_t len;
+            const uint32_t h = hash(key, len);
+            size_t i = probe(key, len, h);
+            if (slots[i])
+                return slots[i] - 1;
+
+            const uint32_t id = names.size();
+            ASSERT(id < CrawlHashKey::NONE);
+            names.emplace_back(key, len);
+            hashes.push_back(h);
+            slots[i] = id + 1;
+
+            // Keep the load factor at or below one half.
+            if (names.size() * 2 > slots.size())
+            {
+                slots.assign(slots.size() * 2, 0);
+                for (uint32_t j = 0; j < names.size(); ++j)
+                {
+                    const size_t mask = slots.size() - 1;
+                    size_t k = hashes[j] & mask;
+                    while (slots[k])
+                        k = (k + 1) & mask;
+                    slots[k] = j + 1;
+                }
+            }
+            return id;
+        }
+    };
+}
+
+static hash_key_table &_hash_keys()
+{
+    static hash_key_table table;
+    return table;
+}
+
+const uint32_t CrawlHashKey::NONE;
+
+CrawlHashKey::CrawlHashKey(const char *key)
+    : key_id(_hash_keys().intern(key))
+{
+}
+
+CrawlHashKey::CrawlHashKey(const string &key)
+    : CrawlHashKey(key.c_str())
+{
+}
+
+const string &CrawlHashKey::name() const
+{
+    return _hash_keys().names[key_id];
+}
+
+uint32_t CrawlHashKey::find(const char *key)
+{
+    return _hash_keys().find(key);
+}
+
+uint32_t CrawlHashKey::find(const string &key)
+{
+    return find(key.c_str());
+}
+
 //////////////////
 // Misc functions
 
+CrawlHashTable::const_iterator CrawlHashTable::find_id(uint32_t id) const
+{
+    if (id == CrawlHashKey::NONE)
+        return entries.end();
+
+    auto it = lower_bound(entries.begin(), entries.end(), id,
+                          [](const value_type &entry, uint32_t key_id)
+                          { return entry.first.id() < key_id; });
+    if (it != entries.end() && it->first.id() == id)
+        return it;
+    return entries.end();
+}
+
+bool CrawlHashTable::exists(const CrawlHashKey &key) const
+{
+    ACCESS(key.name());
+    ASSERT_VALIDITY();
+    return find_id(key.id()) != end();
+}
+
 bool CrawlHashTable::exists(const string &key) const
 {
     ACCESS(key);
     ASSERT_VALIDITY();
-    return find(key) != end();
+    return find_id(CrawlHashKey::find(key)) != end();
+}
+
+bool CrawlHashTable::exists(const char *key) const
+{
+    ACCESS(key);
+    ASSERT_VALIDITY();
+    return find_id(CrawlHashKey::find(key)) != end();
+}
+
+size_t CrawlHashTable::erase_id(uint32_t id)
+{
+    auto it = find_id(id);
+    if (it == entries.end())
+        return 0;
+    entries.erase(entries.begin() + (it - entries.begin()));
+    return 1;
+}
+
+size_t CrawlHashTable::erase(const CrawlHashKey &key)
+{
+    return erase_id(key.id());
+}
+
+size_t CrawlHashTable::erase(const string &key)
+{
+    return erase_id(CrawlHashKey::find(key));
+}
+
+size_t CrawlHashTable::erase(const char *key)
+{
+    return erase_id(CrawlHashKey::find(key));
 }
 
 void CrawlHashTable::assert_validity() const
@@ -1281,6 +1502,9 @@ void CrawlHashTable::assert_validity() const
         const string          &key = entry.first;
         const CrawlStoreValue &val = entry.second;
 
+        ASSERT(&entry == &entries.front()
+               || (&entry - 1)->first.id() < entry.first.id());
+
         ASSERT(!key.empty());
         string trimmed = trimmed_string(key);
         ASSERT(key == trimmed);
@@ -1333,26 +1557,54 @@ void CrawlHashTable::assert_validity() const
 ////////////////////////////////
 // Accessors to contained values
 
-CrawlStoreValue& CrawlHashTable::get_value(const string &key)
+CrawlStoreValue& CrawlHashTable::get_value(const CrawlHashKey &key)
 {
     ASSERT_VALIDITY();
-    ACCESS(key);
+    ACCESS(key.name());
+
     // Inserts CrawlStoreValue() if the key was not found.
-    return map::operator[](key);
+    auto it = lower_bound(entries.begin(), entries.end(), key.id(),
+                          [](const value_type &entry, uint32_t key_id)
+                          { return entry.first.id() < key_id; });
+    if (it == entries.end() || it->first != key)
+        it = entries.emplace(it, key, CrawlStoreValue());
+    return it->second;
+}
+
+static const CrawlStoreValue &_checked_value(const CrawlHashTable &table,
+                                             CrawlHashTable::const_iterator it,
+                                             const char *key)
+{
+    ASSERTM(it != table.end(), "trying to read non-existent property \"%s\"",
+            key);
+
+    const CrawlStoreValue& store = it->second;
+    ASSERT(store.get_type() != SV_NONE);
+    ASSERT(!(store.get_flags() & SFLAG_UNSET));
+
+    return store;
+}
+
+const CrawlStoreValue& CrawlHashTable::get_value(const CrawlHashKey &key) const
+{
+    ASSERT_VALIDITY();
+    ACCESS(key.name());
+    return _checked_value(*this, find_id(key.id()), key.name().c_str());
 }
 
 const CrawlStoreValue& CrawlHashTable::get_value(const string &key) const
 {
     ASSERT_VALIDITY();
     ACCESS(key);
-    auto iter = find(key);
-    ASSERTM(iter != end(), "trying to read non-existent property \"%s\"", key.c_str());
-
-    const CrawlStoreValue& store = iter->second;
-    ASSERT(store.type != SV_NONE);
-    ASSERT(!(store.flags & SFLAG_UNSET));
+    return _checked_value(*this, find_id(CrawlHashKey::find(key)),
+                          key.c_str());
+}
 
-    return store;
+const CrawlStoreValue& CrawlHashTable::get_value(const char *key) const
+{
+    ASSERT_VALIDITY();
+    ACCESS(key);
+    return _checked_value(*this, find_id(CrawlHashKey::find(key)), key);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -78,6 +78,7 @@ class CrawlStoreValue
 public:
     CrawlStoreValue();
     CrawlStoreValue(const CrawlStoreValue &other);
+    CrawlStoreValue(CrawlStoreValue &&other) noexcept;
 
     ~CrawlStoreValue();
 
@@ -100,6 +101,7 @@ public:
     CrawlStoreValue(const dlua_chunk &val);
 
     CrawlStoreValue &operator = (const CrawlStoreValue &other);
+    CrawlStoreValue &operator = (CrawlStoreValue &&other) noexcept;
 
 protected:
     // These first two fields need to match those in CrawlVector
@@ -241,27 +243,75 @@ protected:
     friend class CrawlVector;
 };
 
-class CrawlHashTable : public map<string, CrawlStoreValue>
+// An interned CrawlHashTable key. Every distinct key string is stored once
+// in a global table and never freed; keys are then compared by id alone.
+// Constructing a CrawlHashKey interns the string, so hot keys should be
+// kept in a static rather than rebuilt on every lookup.
+class CrawlHashKey
+{
+public:
+    CrawlHashKey(const string &key);
+    CrawlHashKey(const char *key);
+
+    uint32_t id() const { return key_id; }
+    const string &name() const;
+    operator const string &() const { return name(); }
+
+    bool operator == (const CrawlHashKey &other) const
+    { return key_id == other.key_id; }
+    bool operator != (const CrawlHashKey &other) const
+    { return key_id != other.key_id; }
+
+    // The id of an already interned key, or NONE if the string has never
+    // been used as a key. Never allocates.
+    static const uint32_t NONE = UINT32_MAX;
+    static uint32_t find(const char *key);
+    static uint32_t find(const string &key);
+
+private:
+    uint32_t key_id;
+};
+
+// A CrawlHashTable keeps its entries in a vector sorted by key id. Most
+// tables hold only a handful of entries, so a binary search over a flat
+// array beats chasing map nodes, and looking up a key that was never
+// interned doesn't need to allocate at all.
+//
+// NOTE: Unlike std::map, adding a key moves the other entries around, so
+// a reference to a value stored directly in the table (e.g. get_int() or
+// get_bool()) must not be held across an insertion into that same table.
+// Values that live on the heap (strings, coordinates, nested tables and
+// vectors, items...) stay put.
+class CrawlHashTable
 {
 public:
     friend class CrawlStoreValue;
 
+    typedef pair<CrawlHashKey, CrawlStoreValue> value_type;
+    typedef vector<value_type>                  container_type;
+    typedef container_type::iterator            iterator;
+    typedef container_type::const_iterator      const_iterator;
+
     void write(writer &) const;
     void read(reader &);
 
+    bool exists(const CrawlHashKey &key) const;
     bool exists(const string &key) const;
+    bool exists(const char *key) const;
 
     void assert_validity() const;
 
     // NOTE: If the const versions of get_value() or [] are given a
     // key which doesn't exist, they will assert.
+    const CrawlStoreValue& get_value(const CrawlHashKey &key) const;
     const CrawlStoreValue& get_value(const string &key) const;
-    const CrawlStoreValue& get_value(const char *key) const
-    { return get_value(string(key)); }
+    const CrawlStoreValue& get_value(const char *key) const;
+    const CrawlStoreValue& operator[] (const CrawlHashKey &key) const
+    { return get_value(key); }
     const CrawlStoreValue& operator[] (const string &key) const
     { return get_value(key); }
     const CrawlStoreValue& operator[] (const char *key) const
-    { return get_value(string(key)); }
+    { return get_value(key); }
 
     // NOTE: If get_value() or [] is given a key which doesn't exist
     // in the table, an unset/empty CrawlStoreValue will be created
@@ -270,12 +320,36 @@ public:
     // hash table has a type (rather than being heterogeneous)
     // then trying to assign a different type to the CrawlStoreValue
     // will assert.
-    CrawlStoreValue& get_value(const string &key);
+    CrawlStoreValue& get_value(const CrawlHashKey &key);
+    CrawlStoreValue& get_value(const string &key)
+    { return get_value(CrawlHashKey(key)); }
     CrawlStoreValue& get_value(const char *key)
-    { return get_value(string(key)); }
-    using map::operator[];
+    { return get_value(CrawlHashKey(key)); }
+    CrawlStoreValue& operator[] (const CrawlHashKey &key)
+    { return get_value(key); }
+    CrawlStoreValue& operator[] (const string &key)
+    { return get_value(key); }
     CrawlStoreValue& operator[] (const char *key)
-    { return get_value(string(key)); }
+    { return get_value(key); }
+
+    // std::map style interface
+    size_t erase(const CrawlHashKey &key);
+    size_t erase(const string &key);
+    size_t erase(const char *key);
+    void   clear() { entries.clear(); }
+    size_t size() const { return entries.size(); }
+    bool   empty() const { return entries.empty(); }
+
+    iterator       begin()       { return entries.begin(); }
+    iterator       end()         { return entries.end(); }
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end()   const { return entries.end(); }
+
+private:
+    const_iterator find_id(uint32_t id) const;
+    size_t erase_id(uint32_t id);
+
+    container_type entries;
 };
 
 // A CrawlVector is the vector version of CrawlHashTable, except that
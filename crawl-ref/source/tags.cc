@@ -240,7 +240,7 @@ void reader::fail_if_not_eof(const string &name)
     char dummy;
     if (_chunk ? _chunk->read(&dummy, 1) :
         _file ? (fgetc(_file) != EOF) :
-        _read_offset >= _pbuf->size())
+        _read_offset < _pbuf->size())
     {
         fail("Incomplete read of \"%s\" - aborting.", name.c_str());
     }
@@ -2800,6 +2800,7 @@ static void _tag_read_you(reader &th)
         you.melded.set(i, unmarshallBoolean(th));
     for (int i = count; i < NUM_EQUIP; ++i)
         you.melded.set(i, false);
+    you.equipment_changed();
 #if TAG_MAJOR_VERSION == 34
     if (th.getMinorVersion() >= TAG_MINOR_TRACK_REGEN_ITEMS)
     {
@@ -4211,9 +4212,15 @@ static void _tag_read_you(reader &th)
     if (th.getMinorVersion() < TAG_MINOR_STICKY_FLAME)
     {
         if (you.props.exists("napalmer"))
-            you.props[STICKY_FLAMER_KEY] = you.props["napalmer"];
+        {
+            const CrawlStoreValue napalmer = you.props["napalmer"];
+            you.props[STICKY_FLAMER_KEY] = napalmer;
+        }
         if (you.props.exists("napalm_aux"))
-            you.props[STICKY_FLAME_AUX_KEY] = you.props["napalm_aux"];
+        {
+            const CrawlStoreValue napalm_aux = you.props["napalm_aux"];
+            you.props[STICKY_FLAME_AUX_KEY] = napalm_aux;
+        }
     }
 
     if (you.duration[DUR_EXCRUCIATING_WOUNDS] && !you.props.exists(ORIGINAL_BRAND_KEY))
@@ -4279,7 +4286,8 @@ static void _tag_read_you(reader &th)
 
     if (you.props.exists("tornado_since"))
     {
-        you.props[POLAR_VORTEX_KEY] = you.props["tornado_since"].get_int();
+        const int since = you.props["tornado_since"].get_int();
+        you.props[POLAR_VORTEX_KEY] = since;
         you.props.erase("tornado_since");
     }
 
@@ -4405,6 +4413,7 @@ static void _tag_read_you_items(reader &th)
             {
                 you.equip[i] = -1;
                 you.melded.set(i, false);
+                you.equipment_changed();
                 continue;
             }
             // likewise the boots of the Assassin before it became a hat
@@ -4413,6 +4422,7 @@ static void _tag_read_you_items(reader &th)
             {
                 you.equip[i] = -1;
                 you.melded.set(i, false);
+                you.equipment_changed();
                 continue;
             }
             // and the staves of Dispater/Wucad Mu/Battle before orbification
@@ -4423,6 +4433,7 @@ static void _tag_read_you_items(reader &th)
             {
                 you.equip[i] = -1;
                 you.melded.set(i, false);
+                you.equipment_changed();
                 continue;
             }
 #endif
@@ -5058,9 +5069,9 @@ static void _tag_construct_level(writer &th)
 
     // how many clouds?
     marshallShort(th, env.cloud.size());
-    for (const auto& entry : env.cloud)
+    for (const coord_def &pos : env.cloud.positions())
     {
-        const cloud_struct& cloud = entry.second;
+        const cloud_struct& cloud = *cloud_at(pos);
         marshallByte(th, cloud.type);
         ASSERT(cloud.type != CLOUD_NONE);
         ASSERT_IN_BOUNDS(cloud.pos);
@@ -5864,7 +5875,7 @@ void marshallMapCell(writer &th, const map_cell &cell)
 
     if (flags & MAP_SERIALIZE_CLOUD)
     {
-        cloud_info* ci = cell.cloudinfo();
+        const cloud_info* ci = cell.cloudinfo();
         marshallUnsigned(th, ci->type);
         marshallUnsigned(th, ci->colour);
         marshallUnsigned(th, ci->duration);
@@ -6601,9 +6612,11 @@ static void _tag_read_level(reader &th)
             unmarshallMapCell(th, env.map_knowledge[i][j]);
             // Fixup positions
             if (env.map_knowledge[i][j].monsterinfo())
-                env.map_knowledge[i][j].monsterinfo()->pos = coord_def(i, j);
+                env.map_knowledge[i][j].mutable_monsterinfo()->pos
+                    = coord_def(i, j);
             if (env.map_knowledge[i][j].cloudinfo())
-                env.map_knowledge[i][j].cloudinfo()->pos = coord_def(i, j);
+                env.map_knowledge[i][j].mutable_cloudinfo()->pos
+                    = coord_def(i, j);
 
             env.map_knowledge[i][j].flags &= ~MAP_VISIBLE_FLAG;
             if (env.map_knowledge[i][j].seen())
@@ -6671,7 +6684,7 @@ static void _tag_read_level(reader &th)
         // 0.18-a0-629-g16988c9.
         if (!cell_is_solid(cloud.pos))
 #endif
-            env.cloud[cloud.pos] = cloud;
+            env.cloud.insert(cloud.pos, cloud);
     }
 
     EAT_CANARY;
@@ -7377,7 +7390,8 @@ void unmarshallMonster(reader &th, monster& m)
 
     if (m.props.exists("siren_call"))
     {
-        m.props[MERFOLK_AVATAR_CALL_KEY] = m.props["siren_call"].get_bool();
+        const bool called = m.props["siren_call"].get_bool();
+        m.props[MERFOLK_AVATAR_CALL_KEY] = called;
         m.props.erase("siren_call");
     }
 
@@ -0,0 +1,38 @@
+-- Check map tag bookkeeping through the dgn tag bindings.
+
+local map = dgn.map_by_index(0)
+assert(map, "No maps loaded")
+local original = dgn.tags(map)
+
+dgn.tags(map, nil)
+assert(dgn.tags(map) == "", "Tags not cleared: " .. dgn.tags(map))
+
+dgn.tags(map, "test_tag_b test_tag_a  test_tag_b")
+assert(dgn.tags(map) == "test_tag_a test_tag_b",
+       "Bad tag string: " .. dgn.tags(map))
+assert(dgn.has_tag(map, "test_tag_a"))
+assert(dgn.has_tag(map, "test_tag_b"))
+assert(not dgn.has_tag(map, "test_tag_never_seen"))
+assert(not dgn.has_tag(map, ""))
+
+dgn.tags_remove(map, "test_tag_a test_tag_never_seen")
+assert(not dgn.has_tag(map, "test_tag_a"))
+assert(dgn.has_tag(map, "test_tag_b"))
+
+-- Enough tags to share bits in the set's summary mask.
+local many = {}
+for i = 1, 100 do
+  table.insert(many, "test_tag_" .. i)
+end
+dgn.tags(map, table.concat(many, " "))
+for i = 1, 100, 7 do
+  dgn.tags_remove(map, "test_tag_" .. i)
+end
+for i = 1, 100 do
+  assert(dgn.has_tag(map, "test_tag_" .. i) == (i % 7 ~= 1),
+         "Wrong membership for test_tag_" .. i)
+end
+
+dgn.tags(map, nil)
+dgn.tags(map, original)
+assert(dgn.tags(map) == original)
@@ -0,0 +1,69 @@
+-- Stage small random fights between spellcasters and archers with tracer
+-- checking turned on. fire_tracer() then runs both the lightweight monster
+-- tracer and the full bolt::fire() path for every tracer fired, and asserts
+-- that they agree.
+
+local fighters = {
+  "orc wizard", "orc priest", "ogre mage", "deep elf annihilator",
+  "fire giant", "frost giant", "titan", "storm dragon", "golden dragon",
+  "centaur warrior", "yaktaur captain", "naga sharpshooter",
+  "deep elf master archer", "lich", "salamander mystic", "shock serpent",
+  "iron imp", "blizzard demon", "spriggan air mage", "crystal guardian",
+  "golden eye"
+}
+
+local rounds = 10
+local turns  = 15
+local x1, y1, x2, y2 = 10, 10, 30, 25
+
+local function place_fighter(team)
+  local name = fighters[crawl.random2(#fighters) + 1]
+  for tries = 1, 50 do
+    local x = crawl.random_range(x1 + 1, x2 - 1)
+    local y = crawl.random_range(y1 + 1, y2 - 1)
+    if dgn.is_passable(x, y) and not dgn.mons_at(x, y) then
+      return dgn.create_monster(x, y, "generate_awake " .. name
+                                      .. " att:" .. team)
+    end
+  end
+end
+
+local function fight_round()
+  dgn.reset_level()
+  dgn.fill_grd_area(1, 1, dgn.GXM - 2, dgn.GYM - 2, 'rock_wall')
+  dgn.fill_grd_area(x1, y1, x2, y2, 'floor')
+
+  -- A few pillars so that some bolts bounce and some are blocked.
+  for i = 1, 6 do
+    dgn.grid(crawl.random_range(x1 + 2, x2 - 2),
+             crawl.random_range(y1 + 2, y2 - 2), 'stone_wall')
+  end
+
+  you.moveto(x1 + 1, y1 + 1)
+  debug.los_changed()
+
+  for i = 1, 4 do
+    place_fighter("hostile")
+    place_fighter("friendly")
+  end
+
+  for turn = 1, turns do
+    for y = y1, y2 do
+      for x = x1, x2 do
+        local mons = dgn.mons_at(x, y)
+        if mons then
+          debug.handle_monster_move(mons)
+        end
+      end
+    end
+  end
+  dgn.dismiss_monsters()
+end
+
+debug.disable("death")
+debug.check_tracers(true)
+for i = 1, rounds do
+  fight_round()
+end
+debug.check_tracers(false)
+debug.disable("death", false)
@@ -61,6 +61,7 @@
 #include "tileview.h"
 #include "transform.h"
 #include "travel.h"
+#include "turn-profile.h"
 #include "ui.h"
 #include "unicode.h"
 #include "unwind.h"
@@ -189,6 +190,8 @@ void TilesFramework::finish_message()
 {
     if (m_msg_buf.size() == 0)
         return;
+    TURN_PROFILE_SCOPE(webtiles);
+    TURN_PROFILE_COUNT(webtiles_bytes, m_msg_buf.size());
 #ifdef DEBUG_WEBSOCKETS
     const int initial_buf_size = m_msg_buf.size();
     fprintf(stderr, "websocket: About to send %d bytes.\n", initial_buf_size);
@@ -1051,6 +1054,7 @@ player_info::player_info()
     _state_ever_synced = false;
     for (auto &eq : equip)
         eq = -1;
+    inv_colours.init(-1);
     position = coord_def(-1, -1);
 }
 
@@ -1237,7 +1241,8 @@ void TilesFramework::_send_player(bool force_full)
         {
             item.plus -= 1 * you.corrosion_amount();
         }
-        _send_item(c.inv[i], item, c.inv_uselessness[i], force_full);
+        _send_item(c.inv[i], item, c.inv_uselessness[i], c.inv_names[i],
+                   c.inv_colours[i], force_full);
         json_close_object(true);
     }
     json_close_object(true);
@@ -1309,6 +1314,7 @@ static string _qty_field_name(const item_def &item)
 
 void TilesFramework::_send_item(item_def& current, const item_def& next,
                                 bool& current_uselessness,
+                                string& current_name, int& current_colour,
                                 bool force_full)
 {
     bool changed = false;
@@ -1370,12 +1376,11 @@ void TilesFramework::_send_item(item_def& current, const item_def& next,
 
     if (changed && defined)
     {
+        // Compare against what was last sent, rather than naming the old
+        // item again.
         string name = next.name(DESC_A, true, false, true);
-        if (force_full || current.name(DESC_A, true, false, true) != name
-            || xp_evoker_changed)
-        {
+        if (force_full || current_name != name || xp_evoker_changed)
             json_write_string("name", name);
-        }
 
         // -1 in this field means don't show. *note*: showing in the action
         // panel has undefined behavior for item types that don't have a
@@ -1385,18 +1390,8 @@ void TilesFramework::_send_item(item_def& current, const item_def& next,
 
         const string prefix = item_prefix(next);
         const int prefcol = menu_colour(next.name(DESC_INVENTORY), prefix, "inventory", false);
-        if (force_full)
+        if (force_full || current_colour != prefcol)
             json_write_int("col", macro_colour(prefcol));
-        else
-        {
-            const string current_prefix = item_prefix(current);
-            const int current_prefcol = menu_colour(
-                current.name(DESC_INVENTORY), current_prefix,
-                "inventory", false);
-
-            if (current_prefcol != prefcol)
-                json_write_int("col", macro_colour(prefcol));
-        }
 
         tileidx_t tile = tileidx_item(next);
         if (force_full || tileidx_item(current) != tile || xp_evoker_changed)
@@ -1410,6 +1405,8 @@ void TilesFramework::_send_item(item_def& current, const item_def& next,
         }
 
         current = next;
+        current_name = name;
+        current_colour = prefcol;
         if (is_xp_evoker(current))
             current.plus = evoker_charges(current.sub_type);
         if (in_inventory(current))
@@ -1960,13 +1957,19 @@ void TilesFramework::_send_monster(const coord_def &gc, const monster_info* m,
     if (last == nullptr)
         force_full = true;
 
-    if (force_full || (last->full_name() != m->full_name()))
-        json_write_string("name", m->full_name());
+    // Compare snapshots rather than whole monster_infos: the previous one
+    // was made when it was sent, and an unchanged cell shares its
+    // monster_info (and so its snapshot) with the last map we sent.
+    const monster_snapshot &next = m->snapshot();
+    const monster_snapshot *prev = force_full ? nullptr : &last->snapshot();
+
+    if (!prev || prev->name != next.name)
+        json_write_string("name", next.name);
 
-    if (force_full || (last->pluralised_name() != m->pluralised_name()))
-        json_write_string("plural", m->pluralised_name());
+    if (!prev || prev->plural != next.plural)
+        json_write_string("plural", next.plural);
 
-    if (force_full || last->type != m->type)
+    if (!prev || prev->type != next.type)
     {
         json_write_int("type", m->type);
 
@@ -1978,13 +1981,13 @@ void TilesFramework::_send_monster(const coord_def &gc, const monster_info* m,
         json_close_object();
     }
 
-    if (force_full || last->attitude != m->attitude)
+    if (!prev || prev->attitude != next.attitude)
         json_write_int("att", m->attitude);
 
-    if (force_full || last->base_type != m->base_type)
+    if (!prev || prev->base_type != next.base_type)
         json_write_int("btype", m->base_type);
 
-    if (force_full || last->threat != m->threat)
+    if (!prev || prev->threat != next.threat)
         json_write_int("threat", m->threat);
 
     // tiebreakers for two monsters with the same custom name
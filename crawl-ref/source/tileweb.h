@@ -83,6 +83,9 @@ struct player_info
 
     FixedVector<item_def, ENDOFPACK> inv;
     FixedVector<bool, ENDOFPACK> inv_uselessness;
+    // The name and colour last sent for each inventory item.
+    FixedVector<string, ENDOFPACK> inv_names;
+    FixedVector<int, ENDOFPACK> inv_colours;
     FixedVector<int8_t, NUM_EQUIP> equip;
     bool offhand_weapon;
     int8_t quiver_item;
@@ -330,6 +333,7 @@ protected:
     void _send_player(bool force_full = false);
     void _send_item(item_def& current, const item_def& next,
                     bool& current_uselessness,
+                    string& current_name, int& current_colour,
                     bool force_full);
     void _send_messages();
 };
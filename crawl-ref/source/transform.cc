@@ -2099,6 +2099,7 @@ void unset_default_form()
 
     you.default_form = transformation::none;
     you.active_talisman.clear();
+    you.equipment_changed();
 
     if (is_artefact(talisman))
         unequip_artefact_effect(talisman, nullptr, false, EQ_NONE, false);
@@ -2109,6 +2110,7 @@ void set_default_form(transformation t, const item_def *source)
     item_def talisman = you.active_talisman;
     you.active_talisman.clear();
     you.default_form = t;
+    you.equipment_changed();
 
     if (is_artefact(talisman))
         unequip_artefact_effect(talisman, nullptr, false, EQ_NONE, false);
@@ -2116,6 +2118,7 @@ void set_default_form(transformation t, const item_def *source)
     if (source)
     {
         you.active_talisman = *source; // iffy
+        you.equipment_changed();
         if (is_artefact(you.active_talisman))
             equip_artefact_effect(you.active_talisman, nullptr, false, EQ_NONE);
     }
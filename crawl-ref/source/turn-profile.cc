@@ -0,0 +1,147 @@
+/**
+ * @file
+ * @brief Per-turn timers and counters for the main game loop.
+**/
+
+#include "AppHdr.h"
+
+#ifdef DEBUG_TURN_PROFILE
+
+#include "turn-profile.h"
+
+#include <cinttypes>
+
+#include "files.h"
+#include "message.h"
+#include "scroller.h"
+#include "stringutil.h"
+
+static const char *_timer_names[] =
+{
+    "world_reacts", "monsters", "clouds", "view", "los", "webtiles",
+};
+COMPILE_CHECK(ARRAYSZ(_timer_names) == (int)turn_timer::NUM_TIMERS);
+
+static const char *_counter_names[] =
+{
+    "monster_moves", "clouds", "los_updates", "webtiles_bytes",
+};
+COMPILE_CHECK(ARRAYSZ(_counter_names) == (int)turn_counter::NUM_COUNTERS);
+
+// Per-turn values, bucketed by powers of two: bucket 0 holds zeroes and
+// bucket b holds values from 2^(b-1) up to 2^b - 1.
+#define TURN_PROFILE_BUCKETS 48
+
+struct turn_histogram
+{
+    int64_t buckets[TURN_PROFILE_BUCKETS];
+    int64_t total;
+    int64_t max;
+
+    turn_histogram() : buckets(), total(0), max(0) { }
+
+    void add(int64_t value)
+    {
+        int bucket = 0;
+        while (bucket < TURN_PROFILE_BUCKETS - 1 && value >> bucket)
+            ++bucket;
+        ++buckets[bucket];
+        total += value;
+        max = std::max(max, value);
+    }
+
+    // An upper bound for the value that a fraction q of turns stayed under.
+    int64_t percentile(int64_t turns, double q) const
+    {
+        const int64_t wanted = (int64_t)(turns * q + 0.5);
+        int64_t seen = 0;
+        for (int b = 0; b < TURN_PROFILE_BUCKETS; ++b)
+        {
+            seen += buckets[b];
+            if (seen >= wanted && seen > 0)
+                return b ? std::min(max, (int64_t(1) << b) - 1) : 0;
+        }
+        return max;
+    }
+};
+
+static int64_t _turn_nsecs[(int)turn_timer::NUM_TIMERS];
+static int64_t _turn_counts[(int)turn_counter::NUM_COUNTERS];
+static turn_histogram _timer_hist[(int)turn_timer::NUM_TIMERS];
+static turn_histogram _counter_hist[(int)turn_counter::NUM_COUNTERS];
+static int64_t _turns_profiled = 0;
+
+void turn_profile_add_time(turn_timer timer, int64_t nsecs)
+{
+    _turn_nsecs[(int)timer] += nsecs;
+}
+
+void turn_profile_count(turn_counter counter, int n)
+{
+    _turn_counts[(int)counter] += n;
+}
+
+void turn_profile_end_turn()
+{
+    for (int i = 0; i < (int)turn_timer::NUM_TIMERS; ++i)
+    {
+        _timer_hist[i].add(_turn_nsecs[i] / 1000);
+        _turn_nsecs[i] = 0;
+    }
+    for (int i = 0; i < (int)turn_counter::NUM_COUNTERS; ++i)
+    {
+        _counter_hist[i].add(_turn_counts[i]);
+        _turn_counts[i] = 0;
+    }
+    ++_turns_profiled;
+}
+
+static string _report_line(const char *name, const turn_histogram &hist)
+{
+    const int64_t turns = max(_turns_profiled, int64_t(1));
+    return make_stringf("%-15s %12" PRId64 " %9.1f %8" PRId64 " %8" PRId64
+                        " %8" PRId64 " %8" PRId64 "\n",
+                        name, hist.total, (double)hist.total / turns,
+                        hist.percentile(turns, 0.5),
+                        hist.percentile(turns, 0.9),
+                        hist.percentile(turns, 0.99), hist.max);
+}
+
+string turn_profile_report()
+{
+    string report = make_stringf("Turn profile over %" PRId64 " turns. "
+                                 "Percentiles are upper bounds.\n\n",
+                                 _turns_profiled);
+    report += make_stringf("%-15s %12s %9s %8s %8s %8s %8s\n", "time (usec)",
+                           "total", "mean", "p50", "p90", "p99", "max");
+    for (int i = 0; i < (int)turn_timer::NUM_TIMERS; ++i)
+        report += _report_line(_timer_names[i], _timer_hist[i]);
+
+    report += make_stringf("\n%-15s %12s %9s %8s %8s %8s %8s\n", "count",
+                           "total", "mean", "p50", "p90", "p99", "max");
+    for (int i = 0; i < (int)turn_counter::NUM_COUNTERS; ++i)
+        report += _report_line(_counter_names[i], _counter_hist[i]);
+    return report;
+}
+
+void turn_profile_show()
+{
+    formatted_scroller scr(FS_PREWRAPPED_TEXT);
+    scr.add_raw_text(turn_profile_report(), false);
+    scr.set_more();
+    scr.show();
+}
+
+void turn_profile_write(const string &filename)
+{
+    FILE *handle = fopen_replace(filename.c_str());
+    if (!handle)
+    {
+        mprf(MSGCH_ERROR, "Error opening file '%s'", filename.c_str());
+        return;
+    }
+    fputs(turn_profile_report().c_str(), handle);
+    fclose(handle);
+}
+
+#endif
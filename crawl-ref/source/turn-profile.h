@@ -0,0 +1,78 @@
+/**
+ * @file
+ * @brief Per-turn timers and counters for the main game loop.
+ *
+ * Built only with DEBUG_TURN_PROFILE, e.g.
+ *     make EXTERNAL_DEFINES=-DDEBUG_TURN_PROFILE
+ * Otherwise the macros below expand to nothing.
+**/
+
+#pragma once
+
+#ifdef DEBUG_TURN_PROFILE
+
+#include <chrono>
+#include <cstdint>
+
+enum class turn_timer
+{
+    world_reacts,
+    monsters,
+    clouds,
+    view,
+    los,
+    webtiles,
+    NUM_TIMERS
+};
+
+enum class turn_counter
+{
+    monster_moves,
+    clouds,
+    los_updates,
+    webtiles_bytes,
+    NUM_COUNTERS
+};
+
+void turn_profile_add_time(turn_timer timer, int64_t nsecs);
+void turn_profile_count(turn_counter counter, int n);
+void turn_profile_end_turn();
+
+string turn_profile_report();
+void turn_profile_show();
+void turn_profile_write(const string &filename);
+
+// Adds the time until it goes out of scope to the current turn's total.
+class turn_profile_timer
+{
+public:
+    explicit turn_profile_timer(turn_timer t)
+        : timer(t), start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~turn_profile_timer()
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        turn_profile_add_time(timer,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                .count());
+    }
+
+private:
+    turn_timer timer;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define TURN_PROFILE_SCOPE(t) \
+    turn_profile_timer turn_profile_scope_timer(turn_timer::t)
+#define TURN_PROFILE_COUNT(c, n) turn_profile_count(turn_counter::c, n)
+#define TURN_PROFILE_END_TURN() turn_profile_end_turn()
+
+#else
+
+#define TURN_PROFILE_SCOPE(t) ((void)0)
+#define TURN_PROFILE_COUNT(c, n) ((void)0)
+#define TURN_PROFILE_END_TURN() ((void)0)
+
+#endif
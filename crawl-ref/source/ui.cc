@@ -271,8 +271,17 @@ void Bin::set_child(shared_ptr<Widget> child)
 
 void Widget::render()
 {
-    if (m_visible)
-        _render();
+    if (!m_visible)
+        return;
+#ifndef USE_TILE_LOCAL
+    // Console renders are clipped to the damaged part of the screen; the
+    // rest of it is still showing what was drawn last time. Widgets with no
+    // area, like overlays, draw where they like and are always rendered.
+    const Region clip = m_region.aabb_intersect(scissor_stack.top());
+    if (!m_region.empty() && (clip.width <= 0 || clip.height <= 0))
+        return;
+#endif
+    _render();
 }
 
 SizeReq Widget::get_preferred_size(Direction dim, int prosp_width)
@@ -413,6 +422,13 @@ void Widget::_expose()
     ui_root.expose_region(m_region);
 }
 
+void Widget::_expose_region(Region region)
+{
+    region = region.aabb_intersect(m_region);
+    if (region.width > 0 && region.height > 0)
+        ui_root.expose_region(region);
+}
+
 void Widget::set_visible(bool visible)
 {
     if (m_visible == visible)
@@ -2549,15 +2565,19 @@ void UIRoot::render()
     if (should_render_current_regions)
         tiles.render_current_regions();
     glmanager->reset_transform();
+    scissor_stack.push(m_region);
 #else
-    // On console, clear and redraw only the dirty region of the screen
+    // On console, clear and redraw only the dirty region of the screen. A
+    // paint without anything exposed (e.g. force_render()) draws everything
+    // over what is already there.
+    const bool redraw_all = m_dirty_region.empty();
     m_dirty_region = m_dirty_region.aabb_intersect(m_region);
     textcolour(LIGHTGREY);
     textbackground(BLACK);
     clear_text_region(m_dirty_region, BLACK);
+    scissor_stack.push(redraw_all ? m_region : m_dirty_region);
 #endif
 
-    scissor_stack.push(m_region);
 #ifdef USE_TILE_LOCAL
     int cutoff = cutoff_stack.empty() ? 0 : cutoff_stack.back();
     ASSERT(cutoff <= static_cast<int>(m_root.num_children()));
@@ -3328,6 +3348,11 @@ bool has_layout()
     return ui_root.num_children() > 0;
 }
 
+Region render_clip()
+{
+    return scissor_stack.top();
+}
+
 NORETURN void restart_layout()
 {
     throw UIRoot::RestartAllocation();
@@ -3338,8 +3363,12 @@ int getch(KeymapContext km)
     // getch() can be called when there are no widget layouts, i.e.
     // older layout/rendering code is being used. these parts of code don't
     // set a dirty region, so we should do that now. One example of this
-    // is mprf() called from yesno()
-    ui_root.needs_paint = true;
+    // is mprf() called from yesno(). On console, layouts expose what they
+    // change, so keypresses in them only redraw the damaged widgets.
+#ifndef USE_TILE_LOCAL
+    if (!has_layout())
+#endif
+        ui_root.needs_paint = true;
 
     int key;
     bool done = false;
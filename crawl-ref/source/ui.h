@@ -351,6 +351,12 @@ public:
      */
     virtual void _expose();
 
+    /**
+     * Mark part of this widget as needing redraw. On console, only widgets
+     * overlapping the exposed parts of the screen are rendered.
+     */
+    void _expose_region(Region region);
+
     /**
      * Get/set visibility of this widget only, ignoring the visibility of its
      * ancestors, if there are any, or whether it is in a layout at all.
@@ -1276,6 +1282,7 @@ NORETURN void restart_layout();
 int getch(KeymapContext km = KMC_DEFAULT);
 void force_render();
 void render();
+Region render_clip();
 void delay(unsigned int ms);
 
 void set_focused_widget(Widget* w);
@@ -10,11 +10,13 @@
 #include <sys/wait.h>
 #include <poll.h>
 #include <signal.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 
 static pid_t crawl;
 static int tty;
+static long long output_bytes;
 
 static void sigalrm(int signum)
 {
@@ -45,8 +47,10 @@ static void slurp_output()
 
     while (poll(&pfd, 1, 60000) > 0) // 60 seconds with no output -> die die die!
     {
-        if (read(tty, buf, sizeof(buf)) <= 0)
+        ssize_t n = read(tty, buf, sizeof(buf));
+        if (n <= 0)
             break;
+        output_bytes += n;
     }
 
     kill(crawl, SIGTERM); // shooting a zombie is ok, let's make sure it's dead
@@ -101,6 +105,9 @@ int main(int argc, char * const *argv)
         /* Handle error */;
         close(replica);
         slurp_output();
+        // For test/stress/bench: how much the game sent to the terminal.
+        if (getenv("FAKE_PTY_COUNT_BYTES"))
+            fprintf(stderr, "fake_pty: %lld bytes of output\n", output_bytes);
         if (waitpid(crawl, &ret, 0) != crawl)
             return 1; // can't happen
         if (WIFEXITED(ret))
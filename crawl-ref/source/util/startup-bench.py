@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+
+"""
+Time game launch with `crawl -startup-profile`, phase by phase.
+
+Runs the game several times against one data directory, with an empty rc
+file and a scratch save directory, and prints the median of each phase as
+JSON. The first run is discarded, since it builds the des and text db caches.
+Give --baseline with an earlier run's output to report phases that got slower
+than --threshold; the exit status is then 1 if any did.
+
+Run from the source directory:
+    util/startup-bench.py [--runs N] [--baseline old.json] > new.json
+"""
+
+import argparse
+import json
+import os
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+
+
+def profile_once(crawl, dirname, rcfile):
+    out = subprocess.run([crawl, '-startup-profile', '-dir', dirname,
+                          '-rc', rcfile],
+                         check=True, stdout=subprocess.PIPE,
+                         universal_newlines=True).stdout
+    phases = []
+    for line in out.splitlines():
+        line = line.strip()
+        if line.startswith('{'):
+            phases.append(json.loads(line))
+    if not phases:
+        raise RuntimeError('no profile output from %s' % crawl)
+    return phases
+
+
+def summarise(runs):
+    # Phases keep their order; a phase name can repeat at different depths,
+    # so key on both.
+    keys = [(p['phase'], p['depth']) for p in runs[0]]
+    summary = []
+    for i, (name, depth) in enumerate(keys):
+        samples = [run[i] for run in runs
+                   if i < len(run) and run[i]['phase'] == name]
+        summary.append({
+            'phase': name,
+            'depth': depth,
+            'wall_ms': round(statistics.median(s['wall_ms'] for s in samples), 3),
+            'cpu_ms': round(statistics.median(s['cpu_ms'] for s in samples), 3),
+            'heap_bytes': samples[0]['heap_bytes'],
+        })
+    return summary
+
+
+def compare(summary, baseline, threshold):
+    old = {(p['phase'], p['depth']): p for p in baseline}
+    slower = []
+    for p in summary:
+        base = old.get((p['phase'], p['depth']))
+        if not base or base['wall_ms'] < 1:
+            continue
+        ratio = p['wall_ms'] / base['wall_ms']
+        if ratio > 1 + threshold:
+            slower.append('%s: %.1f ms -> %.1f ms (+%d%%)'
+                          % (p['phase'], base['wall_ms'], p['wall_ms'],
+                             round((ratio - 1) * 100)))
+    return slower
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('--crawl', default='./crawl',
+                        help='game binary (default: ./crawl)')
+    parser.add_argument('--runs', type=int, default=10,
+                        help='timed runs after the warm-up run (default: 10)')
+    parser.add_argument('--baseline', help='earlier output to compare with')
+    parser.add_argument('--threshold', type=float, default=0.1,
+                        help='allowed slowdown per phase (default: 0.1)')
+    args = parser.parse_args()
+
+    scratch = tempfile.mkdtemp(prefix='crawl-startup-')
+    try:
+        rcfile = os.path.join(scratch, 'empty.rc')
+        open(rcfile, 'w').close()
+        savedir = os.path.join(scratch, 'saves')
+        os.mkdir(savedir)
+
+        profile_once(args.crawl, savedir, rcfile)
+        runs = [profile_once(args.crawl, savedir, rcfile)
+                for _ in range(args.runs)]
+    finally:
+        shutil.rmtree(scratch)
+
+    summary = summarise(runs)
+    json.dump(summary, sys.stdout, indent=1)
+    print()
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            slower = compare(summary, json.load(f), args.threshold)
+        for line in slower:
+            print(line, file=sys.stderr)
+        return 1 if slower else 0
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -77,6 +77,7 @@
 #include "tiles-build-specific.h"
 #include "traps.h"
 #include "travel.h"
+#include "turn-profile.h"
 #include "unicode.h"
 #include "unwind.h"
 #include "viewchar.h"
@@ -1398,6 +1399,8 @@ static bool _viewwindow_should_render()
  */
 void viewwindow(bool show_updates, bool tiles_only, animation *a, view_renderer *renderer)
 {
+    TURN_PROFILE_SCOPE(view);
+
     if (_view_is_updating)
     {
         // recursive calls to this function can lead to memory corruption or
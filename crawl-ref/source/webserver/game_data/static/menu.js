@@ -289,7 +289,8 @@ function ($, comm, client, ui, enums, cr, util, options, scroller) {
             var item = {
                 level: 2,
                 text: "...",
-                index: i
+                index: i,
+                placeholder: true
             };
             var elem = $("<li>...</li>");
             elem.data("item", item);
@@ -320,6 +321,9 @@ function ($, comm, client, ui, enums, cr, util, options, scroller) {
             var item = menu.items[real_index];
             if (!item) continue;
             var new_item = items_list[i];
+            // the server hasn't made this item yet
+            if (new_item.placeholder)
+                continue;
             if (typeof new_item === "string")
             {
                 new_item = {
@@ -336,6 +340,8 @@ function ($, comm, client, ui, enums, cr, util, options, scroller) {
                 delete item.tiles;
             if (new_item.hotkeys === undefined)
                 delete item.hotkeys;
+            delete item.placeholder;
+            delete item.requested;
 
             set_item_contents(item, item.elem);
         }
@@ -650,6 +656,35 @@ function ($, comm, client, ui, enums, cr, util, options, scroller) {
             last: menu.last_visible,
             hover: menu.last_hovered
         });
+        request_missing_items();
+    }
+
+    // Menus that make their items on demand only send the ones in view;
+    // ask for any placeholders near the visible part of the menu.
+    function request_missing_items()
+    {
+        if (!menu || menu.type == "crt" || client.is_watching())
+            return;
+
+        function missing(i)
+        {
+            var item = menu.items[i];
+            return item && item.placeholder && !item.requested;
+        }
+
+        var page = menu.last_visible - menu.first_visible + 1;
+        var start = Math.max(0, menu.first_visible - page);
+        var end = Math.min(menu.total_items - 1, menu.last_visible + page);
+        while (start <= end && !missing(start))
+            start++;
+        while (start <= end && !missing(end))
+            end--;
+        if (start > end)
+            return;
+
+        for (var i = start; i <= end; ++i)
+            menu.items[i].requested = true;
+        comm.send_message("*request_menu_range", { start: start, end: end });
     }
 
     function schedule_server_scroll()
@@ -895,6 +930,7 @@ function ($, comm, client, ui, enums, cr, util, options, scroller) {
             update_visible_indices();
 
         update_more();
+        request_missing_items();
     }
 
     function menu_scroll_handler(was_server_initiated)
@@ -937,14 +937,26 @@ class CrawlProcessHandler(CrawlProcessHandlerBase):
                                             self.logger,
                                             config.get('recording_term_size'),
                                             env_vars = game.templated("env", username=self.username, default={}),
-                                            game_cwd = game.templated("cwd", username=self.username, default=None),)
+                                            game_cwd = game.templated("cwd", username=self.username, default=None),
+                                            zygote_socket = game.templated("zygote_socket", default=None),)
+            self.process.start_callback = self._on_process_started
             self.process.end_callback = self._on_process_end
             self.process.output_callback = self._on_process_output
             self.process.activity_callback = self.note_activity
             self.process.error_callback = self._on_process_error
 
             self.process.start(self.ttyrec_filename, self._ttyrec_id_header())
+        except Exception:
+            self._on_start_error()
+
+    def _on_process_started(self, error=None):
+        # With a zygote, this is called from the IOLoop once it has forked
+        # the game, after start() has returned.
+        if error is not None:
+            self._on_start_error(error)
+            return
 
+        try:
             self.gen_inprogress_lock()
 
             self.connect(self.socketpath, True)
@@ -957,20 +969,24 @@ class CrawlProcessHandler(CrawlProcessHandlerBase):
 
             self.check_where()
         except Exception:
-            self.logger.warning("Error while starting the Crawl process!", exc_info=True)
-            self.exit_reason = "error"
-            self.exit_message = "Error while starting the Crawl process!\nSomething has gone very wrong; please let a server admin know."
-            self.exit_dump_url = None
+            self._on_start_error()
 
-            if self.process and self.process.is_started():
-                # n.b. we delay a bit here so that the process has more
-                # time to start up, and avoid race conditions. (I couldn't come
-                # up with anything more reliable.) Also, currently
-                # if the connection fails the crawl process will be in a state
-                # where it ignores HUP, and the kill handler is needed.
-                self.stop(delay=True)
-            else:
-                self._on_process_end()
+    def _on_start_error(self, error=None):
+        self.logger.warning("Error while starting the Crawl process!",
+                            exc_info=error or True)
+        self.exit_reason = "error"
+        self.exit_message = "Error while starting the Crawl process!\nSomething has gone very wrong; please let a server admin know."
+        self.exit_dump_url = None
+
+        if self.process and self.process.is_started():
+            # n.b. we delay a bit here so that the process has more
+            # time to start up, and avoid race conditions. (I couldn't come
+            # up with anything more reliable.) Also, currently
+            # if the connection fails the crawl process will be in a state
+            # where it ignores HUP, and the kill handler is needed.
+            self.stop(delay=True)
+        else:
+            self._on_process_end()
 
     def connect(self, socketpath, primary = False):
         self.socketpath = socketpath
@@ -1,9 +1,11 @@
 import asyncio
 import fcntl
+import json
 import os
 import pty
 import resource
 import signal
+import socket
 import struct
 import sys
 import termios
@@ -12,10 +14,12 @@ import time
 import tornado.ioloop
 from tornado.escape import to_unicode
 from tornado.ioloop import IOLoop
+from tornado.iostream import IOStream
 
 from webtiles import util, config
 
 BUFSIZ = 2048
+ZYGOTE_TIMEOUT = 5 # seconds to wait for the zygote to fork a game
 
 class TerminalRecorder(object):
     def __init__(self,
@@ -24,12 +28,15 @@ class TerminalRecorder(object):
                  termsize,
                  env_vars, # type: Dict[str, str]
                  game_cwd, # type: Optional[str]
+                 zygote_socket=None, # type: Optional[str]
                  ):
         """
         Args:
             command: argv of command to run, eg [cmd, args, ...]
             env_vars: dictionary of environment variables to set. The variables
                 COLUMNS, LINES, and TERM cannot be overridden.
+            zygote_socket: if set, ask the `crawl -zygote` server listening
+                on this socket to fork the game, instead of running command[0].
         """
         self.command = command
         self.ttyrec = None
@@ -39,10 +46,12 @@ class TerminalRecorder(object):
         self.termsize = termsize
         self.env_vars = env_vars
         self.game_cwd = game_cwd
+        self.zygote_socket = zygote_socket
 
         self.pid = None
         self.child_fd = None
 
+        self.start_callback = None
         self.end_callback = None
         self.output_callback = None
         self.activity_callback = None
@@ -51,6 +60,11 @@ class TerminalRecorder(object):
         self.errpipe_read = None
         self.error_buffer = b""
 
+        self.zygote_stream = None # type: Optional[IOStream]
+        self.zygote_timeout = None
+        self.zygote_status = None # type: Optional[int]
+        self.pending_signal = None # type: Optional[int]
+
         self.logger = logger
 
     def start(self, ttyrec_filename, id_header):
@@ -66,7 +80,20 @@ class TerminalRecorder(object):
     def is_started(self):
         return self.pid is not None and self.pid != 0
 
+    def _child_env(self):
+        env            = dict(os.environ)
+        env.update(self.env_vars)
+        cols, lines = self.get_terminal_size()
+        env["COLUMNS"] = str(cols)
+        env["LINES"]   = str(lines)
+        env["TERM"]    = "linux"
+        return env
+
     def _spawn(self):
+        if self.zygote_socket:
+            self._spawn_zygote()
+            return
+
         self.errpipe_read, errpipe_write = os.pipe()
 
         self.pid, self.child_fd = pty.fork()
@@ -105,11 +132,7 @@ class TerminalRecorder(object):
                     pass
 
             # And exec
-            env            = dict(os.environ)
-            env.update(self.env_vars)
-            env["COLUMNS"] = str(cols)
-            env["LINES"]   = str(lines)
-            env["TERM"]    = "linux"
+            env = self._child_env()
             if self.game_cwd:
                 os.chdir(self.game_cwd)
             try:
@@ -119,6 +142,92 @@ class TerminalRecorder(object):
 
         # We're the parent
         os.close(errpipe_write)
+        self._add_handlers()
+        if self.start_callback:
+            self.start_callback()
+
+    def _spawn_zygote(self):
+        # The zygote forks the game for us, with our end of a new pty as its
+        # terminal. See zygote.cc for the protocol. This runs on the IOLoop,
+        # so nothing here waits on the zygote: the reply arrives later, in
+        # _handle_zygote_reply, and start_callback is called from there.
+        self.child_fd, slave_fd = pty.openpty()
+        self.errpipe_read, errpipe_write = os.pipe()
+        conn = None
+        try:
+            cols, lines = self.get_terminal_size()
+            s = struct.pack("HHHH", lines, cols, 0, 0)
+            fcntl.ioctl(slave_fd, termios.TIOCSWINSZ, s)
+
+            request = json.dumps({"args": self.command,
+                                  "cwd": self.game_cwd,
+                                  "env": self._child_env()}) + "\n"
+            conn = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+            conn.setblocking(False)
+            # A Unix socket connects at once or fails; it is never left in
+            # progress.
+            conn.connect(self.zygote_socket)
+            data = request.encode("utf-8")
+            fds = struct.pack("iii", slave_fd, slave_fd, errpipe_write)
+            # The descriptors go with the first part of the request, which a
+            # new connection always has room for; the stream sends the rest.
+            sent = conn.sendmsg([data],
+                                [(socket.SOL_SOCKET, socket.SCM_RIGHTS, fds)])
+        except Exception:
+            if conn is not None:
+                conn.close()
+            self._close_child_fds()
+            raise
+        finally:
+            os.close(slave_fd)
+            os.close(errpipe_write)
+
+        self.zygote_stream = IOStream(conn)
+        if sent < len(data):
+            self.zygote_stream.write(data[sent:])
+        self.zygote_timeout = IOLoop.current().call_later(
+            ZYGOTE_TIMEOUT, self._handle_zygote_timeout)
+        IOLoop.current().add_future(self.zygote_stream.read_until(b"\n"),
+                                    self._handle_zygote_reply)
+
+    def _close_child_fds(self):
+        os.close(self.child_fd)
+        os.close(self.errpipe_read)
+        self.child_fd = self.errpipe_read = None
+
+    def _handle_zygote_timeout(self):
+        self.zygote_timeout = None
+        self.zygote_stream.close()
+
+    def _handle_zygote_reply(self, future):
+        try:
+            if self.zygote_timeout is None:
+                raise RuntimeError("The zygote didn't reply in time")
+            IOLoop.current().remove_timeout(self.zygote_timeout)
+            self.zygote_timeout = None
+            response = json.loads(to_unicode(future.result()))
+            if "pid" not in response:
+                raise RuntimeError("Zygote error: %s" % response.get("error"))
+        except Exception as e:
+            self.zygote_stream.close()
+            self.zygote_stream = None
+            self._close_child_fds()
+            if self.ttyrec:
+                self.ttyrec.close()
+            if self.start_callback:
+                self.start_callback(e)
+            return
+
+        self.pid = response["pid"]
+        IOLoop.current().add_future(self.zygote_stream.read_until(b"\n"),
+                                    self._handle_zygote_status)
+        self._add_handlers()
+        if self.start_callback:
+            self.start_callback()
+        if self.pending_signal is not None:
+            self.send_signal(self.pending_signal)
+
+    def _add_handlers(self):
         if not self.ttyrec:
             self.desc = "TerminalRecorder (fd %d)" % self.child_fd
 
@@ -157,6 +266,20 @@ class TerminalRecorder(object):
         if events & IOLoop.ERROR:
             self.poll()
 
+    def _handle_zygote_status(self, future):
+        # The zygote sends the game's exit status, then hangs up.
+        try:
+            status = json.loads(to_unicode(future.result()))
+        except Exception:
+            self.logger.error("Lost the connection to the zygote!")
+            self.zygote_status = 1
+        else:
+            if "signal" in status:
+                self.zygote_status = -status["signal"]
+            else:
+                self.zygote_status = status.get("exit", 1)
+        self.poll()
+
     def _handle_err_read(self, fd, events):
         if events & IOLoop.READ:
             with util.SlowWarning("Slow IO: os.read stderr (session '%s')" % self.desc):
@@ -221,23 +344,35 @@ class TerminalRecorder(object):
 
 
     def send_signal(self, signal):
+        if not self.is_started() and self.zygote_stream is not None:
+            # Still waiting for the zygote to fork the game.
+            self.pending_signal = signal
+            return
         if not self.is_started():
             raise RuntimeError("Can't send a signal without a child process to send it to!")
         os.kill(self.pid, signal)
 
     def poll(self):
         if self.returncode is None:
-            pid, status = os.waitpid(self.pid, os.WNOHANG)
-            if pid == self.pid:
-                if os.WIFSIGNALED(status):
-                    self.returncode = -os.WTERMSIG(status)
-                elif os.WIFEXITED(status):
-                    self.returncode = os.WEXITSTATUS(status)
-                else:
-                    # Should never happen
-                    raise RuntimeError("Unknown child exit status!")
+            if self.zygote_stream is not None:
+                # The game isn't our child; the zygote reports its exit.
+                self.returncode = self.zygote_status
+            else:
+                pid, status = os.waitpid(self.pid, os.WNOHANG)
+                if pid == self.pid:
+                    if os.WIFSIGNALED(status):
+                        self.returncode = -os.WTERMSIG(status)
+                    elif os.WIFEXITED(status):
+                        self.returncode = os.WEXITSTATUS(status)
+                    else:
+                        # Should never happen
+                        raise RuntimeError("Unknown child exit status!")
 
             if self.returncode is not None:
+                if self.zygote_stream is not None:
+                    self.zygote_stream.close()
+                    self.zygote_stream = None
+
                 IOLoop.current().remove_handler(self.child_fd)
                 IOLoop.current().remove_handler(self.errpipe_read)
 
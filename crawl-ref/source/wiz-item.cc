@@ -430,6 +430,9 @@ void wizard_tweak_object()
         else
             die("unhandled keyin");
 
+        // The item may be worn, with its ego counted in the equipment totals.
+        you.equipment_changed();
+
         // cursedness might have changed
         ash_check_bondage();
         auto_id_inventory();
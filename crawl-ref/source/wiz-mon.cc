@@ -516,7 +516,7 @@ void wizard_detect_creatures()
     int count = 0;
     for (monster_iterator mi; mi; ++mi)
     {
-        env.map_knowledge(mi->pos()).set_monster(monster_info(*mi));
+        env.map_knowledge(mi->pos()).emplace_monster(*mi);
         env.map_knowledge(mi->pos()).set_detected_monster(mi->type);
 #ifdef USE_TILE
         tiles.update_minimap(mi->pos());
@@ -925,6 +925,7 @@ void wizard_transform()
     {
         you.default_form = form; // ehhh
         you.active_talisman.clear();
+        you.equipment_changed();
     }
     if (!transform(200, form, true) && you.form != form)
         mpr("Transformation failed.");
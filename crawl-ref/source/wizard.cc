@@ -35,6 +35,7 @@
 #include "stairs.h" // down_stairs
 #include "state.h"
 #include "traps.h" // do_trap_effects
+#include "turn-profile.h"
 #include "wizard-option-type.h"
 #include "wiz-dgn.h"
 #include "wiz-dump.h"
@@ -134,7 +135,9 @@ static void _do_wizard_command(int wiz_command)
     case 'P': debug_place_map(true); break;
     case CONTROL('P'): wizard_list_props(); break;
 
-    // case 'q': break;
+#ifdef DEBUG_TURN_PROFILE
+    case 'q': turn_profile_show(); break;
+#endif
     // case 'Q': break;
     case CONTROL('Q'): wizard_toggle_dprf(); break;
 
@@ -519,6 +522,9 @@ int list_wizard_commands(bool do_redraw_screen)
                        "<w>Ctrl-F</w> double scale fsim\n"
                        "<w>Ctrl-I</w> item generation stats\n"
                        "<w>O</w>      measure exploration time\n"
+#ifdef DEBUG_TURN_PROFILE
+                       "<w>q</w>      show per-turn timing profile\n"
+#endif
                        "<w>Ctrl-T</w> dungeon (D)Lua interpreter\n"
                        "<w>Ctrl-U</w> client (C)Lua interpreter\n"
                        "<w>Ctrl-X</w> Xom effect stats\n"
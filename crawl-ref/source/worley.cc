@@ -194,13 +194,43 @@ namespace worley
         return;
     }
 
-    static void AddSamples(int32_t xi, int32_t yi, int32_t zi, int32_t max_order,
-            double at[3], double *F,
-            double (*delta)[3], uint32_t *ID)
+    /* The feature points of a single cube. Computing these is a good part of
+       the cost of AddSamples(), and neighbouring samples mostly visit the
+       same cubes, so while a batch is active they are remembered in a small
+       direct-mapped cache. The cached values are exactly those that would
+       have been computed, so results don't depend on batching. */
+    struct cube_points
+    {
+        int32_t xi, yi, zi;
+        uint32_t generation;
+        int32_t count;
+        uint32_t id[5];
+        double f[5][3];
+    };
+
+#define CUBE_CACHE_SIZE 1024
+    static cube_points cube_cache[CUBE_CACHE_SIZE];
+    static uint32_t cube_generation = 0;
+    static int batch_depth = 0;
+
+    batch::batch()
+    {
+        // Start each outermost batch with an empty cache; 0 is never used
+        // as a generation, so a zero-initialised slot is always stale.
+        if (!batch_depth++ && !++cube_generation)
+            ++cube_generation;
+    }
+
+    batch::~batch()
     {
-        double dx, dy, dz, fx, fy, fz, d2;
-        int32_t count, i, j, index;
-        uint32_t seed, this_id;
+        --batch_depth;
+    }
+
+    static void _cube_points(int32_t xi, int32_t yi, int32_t zi,
+                             cube_points &cube)
+    {
+        uint32_t seed;
+        int32_t j;
 
         /* Each cube has a random number seed based on the cube's ID number.
            The seed might be better if it were a nonlinear hash like Perlin uses
@@ -209,27 +239,66 @@ namespace worley
         seed=702395077*xi + 915488749*yi + 2120969693*zi;
 
         /* How many feature points are in this cube? */
-        count=Poisson_count[(seed>>24)%256]; /* 256 element lookup table. Use MSB */
+        cube.count=Poisson_count[(seed>>24)%256]; /* 256 element lookup table. Use MSB */
 
         seed=1402024253*seed+586950981; /* churn the seed with good Knuth LCG */
 
-        for (j=0; j<count; j++) /* test and insert each point into our solution */
+        for (j=0; j<cube.count; j++)
         {
-            this_id=seed;
+            cube.id[j]=seed;
             seed=1402024253*seed+586950981; /* churn */
 
             /* compute the 0..1 feature point location's XYZ */
-            fx=(seed+0.5)*(1.0/4294967296.0);
+            cube.f[j][0]=(seed+0.5)*(1.0/4294967296.0);
             seed=1402024253*seed+586950981; /* churn */
-            fy=(seed+0.5)*(1.0/4294967296.0);
+            cube.f[j][1]=(seed+0.5)*(1.0/4294967296.0);
             seed=1402024253*seed+586950981; /* churn */
-            fz=(seed+0.5)*(1.0/4294967296.0);
+            cube.f[j][2]=(seed+0.5)*(1.0/4294967296.0);
             seed=1402024253*seed+586950981; /* churn */
+        }
+    }
 
+    static const cube_points &_find_cube_points(int32_t xi, int32_t yi,
+                                                int32_t zi, cube_points &local)
+    {
+        if (!batch_depth)
+        {
+            _cube_points(xi, yi, zi, local);
+            return local;
+        }
+
+        const uint32_t h = 73856093u * (uint32_t)xi
+                           ^ 19349663u * (uint32_t)yi
+                           ^ 83492791u * (uint32_t)zi;
+        cube_points &slot = cube_cache[(h ^ (h >> 16)) % CUBE_CACHE_SIZE];
+        if (slot.generation != cube_generation
+            || slot.xi != xi || slot.yi != yi || slot.zi != zi)
+        {
+            _cube_points(xi, yi, zi, slot);
+            slot.xi = xi;
+            slot.yi = yi;
+            slot.zi = zi;
+            slot.generation = cube_generation;
+        }
+        return slot;
+    }
+
+    static void AddSamples(int32_t xi, int32_t yi, int32_t zi, int32_t max_order,
+            double at[3], double *F,
+            double (*delta)[3], uint32_t *ID)
+    {
+        double dx, dy, dz, d2;
+        int32_t i, j, index;
+
+        cube_points local;
+        const cube_points &cube = _find_cube_points(xi, yi, zi, local);
+
+        for (j=0; j<cube.count; j++) /* test and insert each point into our solution */
+        {
             /* delta from feature point to sample location */
-            dx=xi+fx-at[0];
-            dy=yi+fy-at[1];
-            dz=zi+fz-at[2];
+            dx=xi+cube.f[j][0]-at[0];
+            dy=yi+cube.f[j][1]-at[1];
+            dz=zi+cube.f[j][2]-at[2];
 
             /* Distance computation!  Lots of interesting variations are
                possible here!
@@ -271,7 +340,7 @@ cases.]
                 }
                 /* Insert the new point's information into the list. */
                 F[index]=d2;
-                ID[index]=this_id;
+                ID[index]=cube.id[j];
                 delta[index][0]=dx;
                 delta[index][1]=dy;
                 delta[index][2]=dz;
@@ -71,4 +71,16 @@ struct noise_datum
 };
 
 noise_datum noise(double x, double y, double z);
+
+// While a batch is alive, noise() remembers the feature points of the cubes
+// it visits, so that a sweep over nearby points doesn't keep regenerating
+// them. The results are identical with or without a batch. Batches nest.
+class batch
+{
+public:
+    batch();
+    ~batch();
+    batch(const batch &) = delete;
+    batch &operator=(const batch &) = delete;
+};
 }
@@ -0,0 +1,469 @@
+/**
+ * @file
+ * @brief Fork server (-zygote): initialise once, then fork a process for
+ *        each game or query that the webtiles server asks for.
+ *
+ * The server connects to the zygote's socket and sends one line of JSON:
+ *     {"args": ["crawl", "-name", ...], "cwd": "...", "env": {"K": "v"}}
+ * with up to three file descriptors attached (SCM_RIGHTS), which become the
+ * child's stdin, stdout and stderr. If stdin is a terminal, it also becomes
+ * the child's controlling terminal. The zygote replies {"pid": n}; when that
+ * child exits it sends {"exit": code} or {"signal": n} and closes the
+ * connection. A bad request gets {"error": "..."} instead.
+ *
+ * Children start from the zygote's memory, so everything done by
+ * startup_preinit() is shared with them copy-on-write.
+**/
+
+#include "AppHdr.h"
+
+#ifdef UNIX
+
+#include "zygote.h"
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "end.h"
+#include "json.h"
+#include "json-wrapper.h"
+#include "startup.h"
+#include "stringutil.h"
+
+extern char **environ;
+
+#define ZYGOTE_MAX_REQUEST 65536
+#define ZYGOTE_MAX_FDS 3
+// How long a client gets to send its whole request.
+#define ZYGOTE_REQUEST_TIMEOUT_MS 5000
+
+struct zygote_request
+{
+    vector<string> args;
+    string cwd;
+    vector<pair<string, string>> env;
+    vector<int> fds;
+};
+
+static int _sigchld_pipe[2] = { -1, -1 };
+
+static void _handle_sigchld(int)
+{
+    const int saved_errno = errno;
+    // If the pipe is full, a wakeup is already pending, so failure is fine.
+    ssize_t unused = write(_sigchld_pipe[1], "", 1);
+    UNUSED(unused);
+    errno = saved_errno;
+}
+
+static void _send_line(int fd, const string &line)
+{
+    const string msg = line + "\n";
+    size_t done = 0;
+    while (done < msg.size())
+    {
+        const ssize_t n = write(fd, msg.data() + done, msg.size() - done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        // If the server has gone away, there's nobody left to tell.
+        if (n <= 0)
+            return;
+        done += n;
+    }
+}
+
+static string _error_json(const string &error)
+{
+    char *quoted = json_encode_string(error.c_str());
+    const string json = make_stringf("{\"error\":%s}", quoted);
+    free(quoted);
+    return json;
+}
+
+static void _close_fds(vector<int> &fds)
+{
+    for (int fd : fds)
+        close(fd);
+    fds.clear();
+}
+
+// A connection whose request hasn't all arrived yet.
+struct zygote_conn
+{
+    zygote_request req;
+    string line;
+    chrono::steady_clock::time_point deadline;
+};
+
+/**
+ * Read whatever the client has sent so far, and any descriptors sent along
+ * with it, without waiting for more.
+ *
+ * @returns 1 once the request line is complete, 0 if more is to come, or -1
+ *          with error set if the request is bad or the client has gone.
+ */
+static int _receive_request(int conn, zygote_conn &pending, string &error)
+{
+    char buf[4096];
+    iovec iov = { buf, sizeof(buf) };
+    union
+    {
+        cmsghdr align;
+        char data[CMSG_SPACE(sizeof(int) * ZYGOTE_MAX_FDS)];
+    } control;
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data;
+    msg.msg_controllen = sizeof(control.data);
+
+    const ssize_t n = recvmsg(conn, &msg, MSG_DONTWAIT);
+    if (n < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+        return 0;
+    if (n <= 0)
+    {
+        error = "incomplete request";
+        return -1;
+    }
+
+    vector<int> &fds = pending.req.fds;
+    for (cmsghdr *c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c))
+    {
+        if (c->cmsg_level != SOL_SOCKET || c->cmsg_type != SCM_RIGHTS)
+            continue;
+        const size_t count = (c->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (size_t i = 0; i < count; ++i)
+        {
+            int fd;
+            memcpy(&fd, CMSG_DATA(c) + i * sizeof(int), sizeof(int));
+            fds.push_back(fd);
+        }
+    }
+    if (msg.msg_flags & MSG_CTRUNC || fds.size() > ZYGOTE_MAX_FDS)
+    {
+        error = "too many file descriptors";
+        return -1;
+    }
+
+    pending.line.append(buf, n);
+    const size_t end_of_line = pending.line.find('\n');
+    if (end_of_line == string::npos)
+    {
+        if (pending.line.size() > ZYGOTE_MAX_REQUEST)
+        {
+            error = "request too long";
+            return -1;
+        }
+        return 0;
+    }
+    pending.line.resize(end_of_line);
+    return 1;
+}
+
+// Check a complete request line and fill in req from it.
+static bool _parse_request(const string &line, zygote_request &req,
+                           string &error)
+{
+    JsonWrapper json(json_decode(line.c_str()));
+    if (!json.node || json->tag != JSON_OBJECT)
+    {
+        error = "request is not a JSON object";
+        return false;
+    }
+
+    JsonNode *node;
+    JsonNode *args = json_find_member(json.node, "args");
+    if (args && args->tag == JSON_ARRAY)
+    {
+        json_foreach(node, args)
+        {
+            if (node->tag != JSON_STRING)
+            {
+                error = "args must be strings";
+                return false;
+            }
+            req.args.emplace_back(node->string_);
+        }
+    }
+    if (req.args.empty())
+    {
+        error = "no args";
+        return false;
+    }
+
+    JsonNode *cwd = json_find_member(json.node, "cwd");
+    if (cwd && cwd->tag == JSON_STRING)
+        req.cwd = cwd->string_;
+    else if (cwd && cwd->tag != JSON_NULL)
+    {
+        error = "cwd must be a string";
+        return false;
+    }
+
+    JsonNode *env = json_find_member(json.node, "env");
+    if (env && env->tag == JSON_OBJECT)
+    {
+        json_foreach(node, env)
+        {
+            if (node->tag != JSON_STRING)
+            {
+                error = "env values must be strings";
+                return false;
+            }
+            req.env.emplace_back(node->key, node->string_);
+        }
+    }
+    else if (env && env->tag != JSON_NULL)
+    {
+        error = "env must be an object";
+        return false;
+    }
+
+    return true;
+}
+
+static vector<string> _child_args;
+static vector<char *> _child_argv;
+
+// In a freshly forked child: set up the process the request asked for.
+static void _become_child(zygote_request &req, int &argc, char **&argv)
+{
+    setsid();
+
+    // Move the descriptors clear of 0-2 first, so that none of them gets
+    // overwritten before it has been put in place.
+    for (int &fd : req.fds)
+    {
+        const int moved = fcntl(fd, F_DUPFD, 3);
+        close(fd);
+        fd = moved;
+    }
+    for (size_t i = 0; i < req.fds.size(); ++i)
+    {
+        dup2(req.fds[i], i);
+        close(req.fds[i]);
+    }
+    if (!req.fds.empty() && isatty(STDIN_FILENO))
+        ioctl(STDIN_FILENO, TIOCSCTTY, 0);
+
+    if (!req.cwd.empty() && chdir(req.cwd.c_str()) < 0)
+    {
+        fprintf(stderr, "Can't change to %s: %s\n", req.cwd.c_str(),
+                strerror(errno));
+        _exit(1);
+    }
+
+    vector<string> old_names;
+    for (char **var = environ; *var; ++var)
+    {
+        const char *eq = strchr(*var, '=');
+        old_names.emplace_back(*var, eq ? eq - *var : strlen(*var));
+    }
+    for (const string &name : old_names)
+        unsetenv(name.c_str());
+    for (const auto &var : req.env)
+        setenv(var.first.c_str(), var.second.c_str(), 1);
+
+    _child_args = req.args;
+    _child_argv.clear();
+    for (string &arg : _child_args)
+        _child_argv.push_back(&arg[0]);
+    _child_argv.push_back(nullptr);
+    argc = _child_args.size();
+    argv = _child_argv.data();
+}
+
+static int _listen(const string &path)
+{
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path))
+        end(1, false, "Zygote socket path is too long: %s", path.c_str());
+    memcpy(addr.sun_path, path.c_str(), path.size());
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        end(1, true, "Can't create zygote socket");
+    unlink(path.c_str());
+    // Anyone who can connect can run a game as us with any arguments, so
+    // only our own user may. The socket refuses connections until listen(),
+    // so there's no window where the umask decides.
+    if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0
+        || chmod(path.c_str(), S_IRUSR | S_IWUSR) < 0
+        || listen(fd, 16) < 0)
+    {
+        end(1, true, "Can't listen on %s", path.c_str());
+    }
+    return fd;
+}
+
+/**
+ * Do the start-up work that every game shares, then serve fork requests on
+ * socket_path until killed.
+ *
+ * @param socket_path The Unix socket to listen on.
+ * @param[out] argc, argv Set in each forked child to the arguments its
+ *                        request gave, for it to start up with.
+ * Only returns in a forked child.
+ */
+void zygote_serve(const string &socket_path, int &argc, char **&argv)
+{
+    startup_preinit();
+
+    const int listen_fd = _listen(socket_path);
+    if (pipe(_sigchld_pipe) < 0)
+        end(1, true, "Can't create zygote pipe");
+    for (int fd : _sigchld_pipe)
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+
+    struct sigaction chld_action, ign_action, old_chld, old_pipe;
+    memset(&chld_action, 0, sizeof(chld_action));
+    chld_action.sa_handler = _handle_sigchld;
+    chld_action.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+    sigemptyset(&chld_action.sa_mask);
+    sigaction(SIGCHLD, &chld_action, &old_chld);
+    memset(&ign_action, 0, sizeof(ign_action));
+    ign_action.sa_handler = SIG_IGN;
+    sigemptyset(&ign_action.sa_mask);
+    sigaction(SIGPIPE, &ign_action, &old_pipe);
+
+    // Each running child, and the connection that asked for it.
+    map<pid_t, int> children;
+    // Connections still sending their requests. Nothing here waits on any
+    // one client, so one that stalls can't hold up other launches or the
+    // exit reports; it just runs out of time.
+    map<int, zygote_conn> pending;
+
+    while (true)
+    {
+        vector<pollfd> fds = { { listen_fd, POLLIN, 0 },
+                               { _sigchld_pipe[0], POLLIN, 0 } };
+        int timeout = -1;
+        const auto now = chrono::steady_clock::now();
+        for (const auto &entry : pending)
+        {
+            fds.push_back({ entry.first, POLLIN, 0 });
+            const int left = max<int>(0,
+                chrono::duration_cast<chrono::milliseconds>(
+                    entry.second.deadline - now).count() + 1);
+            if (timeout < 0 || left < timeout)
+                timeout = left;
+        }
+
+        if (poll(fds.data(), fds.size(), timeout) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            end(1, true, "Zygote poll failed");
+        }
+
+        if (fds[1].revents & POLLIN)
+        {
+            char buf[64];
+            while (read(_sigchld_pipe[0], buf, sizeof(buf)) > 0)
+                ;
+
+            int status;
+            pid_t pid;
+            while ((pid = waitpid(-1, &status, WNOHANG)) > 0)
+            {
+                auto child = children.find(pid);
+                if (child == children.end())
+                    continue;
+                _send_line(child->second, WIFSIGNALED(status)
+                    ? make_stringf("{\"signal\":%d}", WTERMSIG(status))
+                    : make_stringf("{\"exit\":%d}", WEXITSTATUS(status)));
+                close(child->second);
+                children.erase(child);
+            }
+        }
+
+        if (fds[0].revents & POLLIN)
+        {
+            const int conn = accept(listen_fd, nullptr, nullptr);
+            if (conn >= 0)
+            {
+                pending[conn].deadline = chrono::steady_clock::now()
+                    + chrono::milliseconds(ZYGOTE_REQUEST_TIMEOUT_MS);
+            }
+        }
+
+        for (size_t i = 2; i < fds.size(); ++i)
+        {
+            const int conn = fds[i].fd;
+            zygote_conn &client = pending[conn];
+            zygote_request &req = client.req;
+            string error;
+            int received = 0;
+            if (fds[i].revents)
+                received = _receive_request(conn, client, error);
+            if (!received && chrono::steady_clock::now() >= client.deadline)
+            {
+                error = "request timed out";
+                received = -1;
+            }
+            if (received > 0 && !_parse_request(client.line, req, error))
+                received = -1;
+            if (received < 0)
+            {
+                _send_line(conn, _error_json(error));
+                _close_fds(req.fds);
+                close(conn);
+                pending.erase(conn);
+                continue;
+            }
+            if (!received)
+                continue;
+
+            const pid_t pid = fork();
+            if (pid == 0)
+            {
+                close(listen_fd);
+                close(conn);
+                for (const auto &child : children)
+                    close(child.second);
+                for (const auto &other : pending)
+                {
+                    if (other.first == conn)
+                        continue;
+                    close(other.first);
+                    for (int fd : other.second.req.fds)
+                        close(fd);
+                }
+                close(_sigchld_pipe[0]);
+                close(_sigchld_pipe[1]);
+                sigaction(SIGCHLD, &old_chld, nullptr);
+                sigaction(SIGPIPE, &old_pipe, nullptr);
+
+                _become_child(req, argc, argv);
+                return;
+            }
+
+            _close_fds(req.fds);
+            pending.erase(conn);
+            if (pid < 0)
+            {
+                _send_line(conn, _error_json(strerror(errno)));
+                close(conn);
+                continue;
+            }
+            _send_line(conn, make_stringf("{\"pid\":%d}", (int) pid));
+            children[pid] = conn;
+        }
+    }
+}
+
+#endif
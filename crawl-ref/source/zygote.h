@@ -0,0 +1,11 @@
+/**
+ * @file
+ * @brief Fork server (-zygote): initialise once, then fork a process for
+ *        each game or query that the webtiles server asks for.
+**/
+
+#pragma once
+
+#ifdef UNIX
+void zygote_serve(const string &socket_path, int &argc, char **&argv);
+#endif